@@ -0,0 +1,981 @@
+// bench/bench_figures.cpp
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "array.h"
+#include "figure.h"
+#include "figures.h"
+#include "figure_algorithms.h"
+#include "figure_store.h"
+#include "figure_variant.h"
+#include "simd_kernels.h"
+#include "spatial_index.h"
+#include "figure_sort.h"
+#include "report_writer.h"
+#include "thread_pool.h"
+#include "concurrent_array.h"
+#include "figure_loader.h"
+#include "figure_pipeline.h"
+#include "figure_collection.h"
+#include "convex_hull.h"
+#include "affine_transform.h"
+
+// Запуск с сохранением результатов в JSON:
+//     ./bench_figures --benchmark_out=bench_figures.json --benchmark_out_format=json
+// (или цель bench_figures_json)
+
+namespace {
+
+using FigurePtr = std::shared_ptr<Figure<int>>;
+
+// Те же квадраты, прямоугольники и трапеции по очереди, что и в тестах
+Array<FigurePtr> make_mixed_figures(size_t count) {
+    Array<FigurePtr> figures;
+    figures.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int s = static_cast<int>(i % 7) + 1;
+        int dx = static_cast<int>(i % 5) - 2, dy = static_cast<int>(i % 3) - 1;
+        Point<int> quad[] = {{dx, dy}, {dx + s, dy}, {dx + s, dy + 2 * s}, {dx, dy + 2 * s}};
+        Point<int> trap[] = {{dx, dy}, {dx + 2 * s, dy}, {dx + s + 1, dy + s}, {dx + 1, dy + s}};
+        switch (i % 3) {
+            case 0: figures.push_back(std::make_shared<Square<int>>(quad)); break;
+            case 1: figures.push_back(std::make_shared<Rectangle<int>>(quad)); break;
+            default: figures.push_back(std::make_shared<Trapezoid<int>>(trap)); break;
+        }
+    }
+    return figures;
+}
+
+// Прямоугольники, разбросанные по квадрату 100000 x 100000
+Array<FigurePtr> make_scattered_figures(size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> coord(0, 100000), size(1, 100);
+    Array<FigurePtr> figures;
+    figures.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int x = coord(rng), y = coord(rng), w = size(rng), h = size(rng);
+        Point<int> quad[] = {{x, y}, {x + w, y}, {x + w, y + h}, {x, y + h}};
+        figures.push_back(std::make_shared<Rectangle<int>>(quad));
+    }
+    return figures;
+}
+
+template<class F>
+F make_quad(int i) {
+    int s = i % 7 + 1;
+    Point<int> points[] = {{i, 0}, {i + s, 0}, {i + s, 2 * s}, {i, 2 * s}};
+    return F(std::span<const Point<int>>(points));
+}
+
+// ==================== Array ====================
+
+void BM_ArrayPushBack(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        Array<int> arr;
+        for (size_t i = 0; i < count; ++i) {
+            arr.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(arr.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArrayPushBack)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+void BM_ArrayPushBackReserved(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        Array<int> arr;
+        arr.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            arr.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(arr.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArrayPushBackReserved)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+void BM_ArrayPushBackFigurePtr(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto figure = make_mixed_figures(1)[0];
+    for (auto _ : state) {
+        Array<FigurePtr> arr;
+        for (size_t i = 0; i < count; ++i) {
+            arr.push_back(figure);
+        }
+        benchmark::DoNotOptimize(arr.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArrayPushBackFigurePtr)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+// Тот же shared_ptr, но без признака is_trivially_relocatable: перенос поштучно
+struct SharedHandle {
+    std::shared_ptr<int> ptr;
+};
+
+template<class A>
+A make_shared_array(size_t count) {
+    auto shared = std::make_shared<int>(1);
+    A arr;
+    arr.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        arr.push_back(typename A::value_type{shared});
+    }
+    return arr;
+}
+
+// Перенос всех элементов в новый буфер: reserve(2n) и shrink_to_fit по очереди
+template<class A>
+void BM_ArrayRelocate(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    A arr = make_shared_array<A>(count);
+    for (auto _ : state) {
+        arr.reserve(2 * count);
+        arr.shrink_to_fit();
+        benchmark::DoNotOptimize(arr.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ArrayRelocate, Array<std::shared_ptr<int>>)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ArrayRelocate, Array<SharedHandle>)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ArrayRelocate, std::vector<std::shared_ptr<int>>)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+// Рост до 10 млн элементов с коэффициентом state.range(0) / 10
+void BM_ArrayGrowthFactor(benchmark::State& state) {
+    auto shared = std::make_shared<int>(1);
+    for (auto _ : state) {
+        Array<std::shared_ptr<int>> arr;
+        arr.set_growth_factor(static_cast<double>(state.range(0)) / 10);
+        for (size_t i = 0; i < 10'000'000; ++i) {
+            arr.push_back(shared);
+        }
+        benchmark::DoNotOptimize(arr.data());
+        state.counters["capacity"] = static_cast<double>(arr.capacity());
+    }
+}
+BENCHMARK(BM_ArrayGrowthFactor)->Arg(15)->Arg(20)->Arg(40)->Unit(benchmark::kMillisecond);
+
+// Вставка в начало и удаление первого элемента
+template<class A>
+void BM_ArrayInsertErase(benchmark::State& state) {
+    A arr = make_shared_array<A>(static_cast<size_t>(state.range(0)));
+    const typename A::value_type value = arr[0];
+    for (auto _ : state) {
+        arr.insert(arr.begin(), value);
+        arr.erase(arr.begin());
+        benchmark::DoNotOptimize(arr.data());
+    }
+}
+BENCHMARK_TEMPLATE(BM_ArrayInsertErase, Array<std::shared_ptr<int>>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ArrayInsertErase, Array<SharedHandle>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ArrayInsertErase, std::vector<std::shared_ptr<int>>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+// ==================== PointContainer ====================
+
+void BM_PointContainerIndexing(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    PointContainer<Point<int>> points;
+    for (size_t i = 0; i < count; ++i) {
+        points.emplace_back(static_cast<int>(i), static_cast<int>(i) * 2);
+    }
+    for (auto _ : state) {
+        long long sum = 0;
+        for (size_t i = 0; i < points.size(); ++i) {
+            sum += points[i].getX() + points[i].getY();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PointContainerIndexing)->RangeMultiplier(8)->Range(4, 1 << 15);
+
+// ==================== Копирование и перемещение ====================
+
+// Трапеция с заданным числом вершин: при N > 4 точки лежат в куче
+Trapezoid<int> make_polygon(size_t count) {
+    Array<Point<int>> points;
+    for (size_t i = 0; i < count; ++i) {
+        points.emplace_back(static_cast<int>(i), static_cast<int>(i % 3));
+    }
+    return Trapezoid<int>(std::span<const Point<int>>(points.data(), points.size()));
+}
+
+void BM_FigureCopy(benchmark::State& state) {
+    const Trapezoid<int> source = make_polygon(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        Trapezoid<int> copy(source);
+        benchmark::DoNotOptimize(&copy);
+    }
+}
+BENCHMARK(BM_FigureCopy)->RangeMultiplier(4)->Range(4, 1024);
+
+// Снимок коллекции из 1024 фигур с заданным числом вершин
+void BM_CollectionCopy(benchmark::State& state) {
+    Array<Trapezoid<int>> source;
+    for (size_t i = 0; i < 1024; ++i) {
+        source.push_back(make_polygon(static_cast<size_t>(state.range(0))));
+    }
+    for (auto _ : state) {
+        Array<Trapezoid<int>> copy(source);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_CollectionCopy)->RangeMultiplier(4)->Range(4, 1024);
+
+void BM_FigureMove(benchmark::State& state) {
+    Trapezoid<int> source = make_polygon(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        // Перемещение туда и обратно, чтобы source снова был заполнен
+        Trapezoid<int> moved(std::move(source));
+        std::destroy_at(&source);
+        std::construct_at(&source, std::move(moved));
+        benchmark::DoNotOptimize(&source);
+    }
+}
+BENCHMARK(BM_FigureMove)->RangeMultiplier(4)->Range(4, 1024);
+
+// ==================== Площадь и центр по типам ====================
+
+// Холодный кэш: перед каждым проходом фигуры копируются заново
+template<class F>
+void BM_AreaCold(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    Array<F> source;
+    for (size_t i = 0; i < count; ++i) {
+        source.push_back(make_quad<F>(static_cast<int>(i)));
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        Array<F> figures(source);
+        state.ResumeTiming();
+        double total = 0;
+        for (const F& figure : figures) {
+            total += figure.area();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_AreaCold, Square<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_AreaCold, Rectangle<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_AreaCold, Trapezoid<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+template<class F>
+void BM_AreaCached(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    Array<F> figures;
+    for (size_t i = 0; i < count; ++i) {
+        figures.push_back(make_quad<F>(static_cast<int>(i)));
+        figures[i].area();
+    }
+    for (auto _ : state) {
+        double total = 0;
+        for (const F& figure : figures) {
+            total += figure.area();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_AreaCached, Square<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_AreaCached, Trapezoid<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+template<class F>
+void BM_CenterCold(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    Array<F> source;
+    for (size_t i = 0; i < count; ++i) {
+        source.push_back(make_quad<F>(static_cast<int>(i)));
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        Array<F> figures(source);
+        state.ResumeTiming();
+        long long sum = 0;
+        for (const F& figure : figures) {
+            sum += figure.center().getX();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_CenterCold, Square<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_CenterCold, Rectangle<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_CenterCold, Trapezoid<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+// ==================== Ввод и вывод ====================
+
+void BM_FigureRead(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::ostringstream text;
+    for (size_t i = 0; i < count; ++i) {
+        text << "0 0 " << i << " 0 " << i << " 2 0 2\n";
+    }
+    const std::string input = text.str();
+    for (auto _ : state) {
+        std::istringstream is(input);
+        double total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            Rectangle<int> rectangle{std::span<const Point<int>>()};
+            is >> rectangle;
+            total += rectangle.area();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_FigureRead)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);
+
+void BM_FigureWrite(benchmark::State& state) {
+    const auto figures = make_mixed_figures(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::ostringstream os;
+        for (const auto& figure : figures) {
+            os << *figure;
+        }
+        benchmark::DoNotOptimize(os.str().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FigureWrite)->RangeMultiplier(16)->Range(1 << 6, 1 << 14);
+
+// Поток, который считает и отбрасывает вывод: замеряется только форматирование
+class CountingBuffer : public std::streambuf {
+public:
+    size_t bytes = 0;
+
+protected:
+    int_type overflow(int_type c) override {
+        ++bytes;
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        bytes += static_cast<size_t>(count);
+        return count;
+    }
+};
+
+// Отчёт, как его печатал main.cpp: несколько вставок в поток на фигуру
+void BM_ReportStream(benchmark::State& state) {
+    const auto figures = make_scattered_figures(static_cast<size_t>(state.range(0)));
+    CountingBuffer buffer;
+    std::ostream os(&buffer);
+    for (auto _ : state) {
+        size_t index = 0;
+        for (const auto& figure : figures) {
+            os << "Figure " << ++index << ":" << "\n";
+            os << *figure;
+            os << "Area: " << static_cast<double>(*figure) << "\n";
+            auto center = figure->center();
+            os << "Center: (" << center.getX() << ", " << center.getY() << ")" << "\n\n";
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(static_cast<int64_t>(buffer.bytes));
+}
+BENCHMARK(BM_ReportStream)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+void BM_ReportWriter(benchmark::State& state) {
+    const auto format = static_cast<ReportFormat>(state.range(0));
+    const auto figures = make_scattered_figures(static_cast<size_t>(state.range(1)));
+    CountingBuffer buffer;
+    std::ostream os(&buffer);
+    ReportWriter<int> report(os, format);
+    for (auto _ : state) {
+        report.write(figures);
+        report.flush();
+    }
+    state.SetLabel(format == ReportFormat::Text ? "text" : format == ReportFormat::Csv ? "csv" : "jsonl");
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+    state.SetBytesProcessed(static_cast<int64_t>(buffer.bytes));
+}
+BENCHMARK(BM_ReportWriter)->ArgsProduct({
+    {static_cast<int>(ReportFormat::Text), static_cast<int>(ReportFormat::Csv), static_cast<int>(ReportFormat::JsonLines)},
+    {1 << 10, 1 << 14, 1 << 18}});
+
+// Текст для загрузчика: те же разбросанные прямоугольники
+std::string make_figure_text(size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> coord(0, 100000), size(1, 100);
+    std::string text;
+    for (size_t i = 0; i < count; ++i) {
+        int x = coord(rng), y = coord(rng), w = size(rng), h = size(rng);
+        text += "rectangle " + std::to_string(x) + " " + std::to_string(y) + " " + std::to_string(x + w) + " "
+              + std::to_string(y) + " " + std::to_string(x + w) + " " + std::to_string(y + h) + " "
+              + std::to_string(x) + " " + std::to_string(y + h) + "\n";
+    }
+    return text;
+}
+
+// Весь путь figures_main: загрузка целиком, затем отчёт и суммарная площадь
+void BM_LoadThenReport(benchmark::State& state) {
+    const std::string text = make_figure_text(static_cast<size_t>(state.range(0)));
+    CountingBuffer buffer;
+    std::ostream os(&buffer);
+    for (auto _ : state) {
+        LoadResult<int> loaded = parse_figures<int>(text);
+        ReportWriter<int> report(os);
+        report.write(loaded.figures);
+        report.end(total_area(loaded.figures));
+        report.flush();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_LoadThenReport)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// То же через конвейер из figure_pipeline.h
+void BM_PipelineReport(benchmark::State& state) {
+    const std::string text = make_figure_text(static_cast<size_t>(state.range(0)));
+    CountingBuffer buffer;
+    std::ostream os(&buffer);
+    for (auto _ : state) {
+        std::istringstream in(text);
+        ReportWriter<int> report(os);
+        PipelineStats stats = run_figure_pipeline<int>(in, report, [](const LoadError&) {});
+        report.end(stats.total_area);
+        report.flush();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_PipelineReport)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ==================== Суммарная площадь ====================
+
+// Цикл из main.cpp: последовательный обход через виртуальный интерфейс
+void BM_MainTotalAreaLoop(benchmark::State& state) {
+    const auto figures = make_mixed_figures(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        double total = 0;
+        for (const auto& figure : figures) {
+            total += static_cast<double>(*figure);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MainTotalAreaLoop)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+void BM_TotalAreaParallel(benchmark::State& state) {
+    const auto figures = make_mixed_figures(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(total_area(figures));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TotalAreaParallel)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+void BM_VariantTotalArea(benchmark::State& state) {
+    const auto figures = VariantFigures<int>::from_figures(make_mixed_figures(static_cast<size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(figures.total_area());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VariantTotalArea)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+void BM_StoreTotalArea(benchmark::State& state) {
+    const auto store = FigureStore<int>::from_figures(make_mixed_figures(static_cast<size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(store.total_area());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StoreTotalArea)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// Сводные величины коллекции: чтение не обходит фигуры
+void BM_CollectionTotalArea(benchmark::State& state) {
+    const FigureCollection<int> collection(make_mixed_figures(static_cast<size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(collection.total_area());
+    }
+}
+BENCHMARK(BM_CollectionTotalArea)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// Цена поддержания сводных величин: одно удаление и одно добавление
+void BM_CollectionEraseInsert(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    FigureCollection<int> collection(make_scattered_figures(count));
+    const auto spare = make_scattered_figures(1024);
+    size_t step = 0;
+    for (auto _ : state) {
+        const size_t index = (step * 2654435761u) % count;
+        FigurePtr figure = collection[index];
+        collection.erase_unordered(index);
+        collection.push_back(spare[step % spare.size()]);
+        benchmark::DoNotOptimize(collection.total_area());
+        benchmark::DoNotOptimize(figure);
+        ++step;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CollectionEraseInsert)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// ==================== SIMD-ядра ====================
+
+void BM_QuadAreas(benchmark::State& state) {
+    const auto level = simd::clamp_level(static_cast<simd::Level>(state.range(0)));
+    if (level != static_cast<simd::Level>(state.range(0))) {
+        state.SkipWithError("instruction set is not supported by this CPU");
+        return;
+    }
+    const auto store = FigureStore<int>::from_figures(make_mixed_figures(static_cast<size_t>(state.range(1))));
+    Array<double> out;
+    out.resize(store.size());
+    for (auto _ : state) {
+        simd::quad_areas(store.xs().data(), store.ys().data(), store.size(), out.data(), level);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetLabel(simd::level_name(level));
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_QuadAreas)->ArgsProduct({
+    {static_cast<int>(simd::Level::Scalar), static_cast<int>(simd::Level::SSE2),
+     static_cast<int>(simd::Level::AVX2), static_cast<int>(simd::Level::AVX512)},
+    {1 << 10, 1 << 16, 1 << 20}});
+
+// ==================== Пространственный индекс ====================
+
+// Окно 1000 x 1000 (около 0,01% площади) в случайном месте
+BoundingBox<int> random_window(std::mt19937& rng) {
+    std::uniform_int_distribution<int> coord(0, 99000);
+    int x = coord(rng), y = coord(rng);
+    return {Point<int>(x, y), Point<int>(x + 1000, y + 1000)};
+}
+
+void BM_SpatialIndexBuild(benchmark::State& state) {
+    const auto figures = make_scattered_figures(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        SpatialIndex<int> index(figures);
+        benchmark::DoNotOptimize(&index);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SpatialIndexBuild)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_WindowQueryIndex(benchmark::State& state) {
+    const SpatialIndex<int> index(make_scattered_figures(static_cast<size_t>(state.range(0))));
+    std::mt19937 rng(1);
+    for (auto _ : state) {
+        size_t found = 0;
+        index.for_each_in(random_window(rng), [&](size_t) { ++found; });
+        benchmark::DoNotOptimize(found);
+    }
+}
+BENCHMARK(BM_WindowQueryIndex)->RangeMultiplier(16)->Range(1 << 12, 1 << 20);
+
+// Линейный просмотр, как без индекса: габарит каждой фигуры по её точкам
+void BM_WindowQueryLinear(benchmark::State& state) {
+    const auto figures = make_scattered_figures(static_cast<size_t>(state.range(0)));
+    std::mt19937 rng(1);
+    for (auto _ : state) {
+        const BoundingBox<int> window = random_window(rng);
+        size_t found = 0;
+        for (const auto& figure : figures) {
+            int min_x = figure->get_point(0).getX(), max_x = min_x;
+            int min_y = figure->get_point(0).getY(), max_y = min_y;
+            for (size_t i = 1; i < figure->get_points_count(); ++i) {
+                const Point<int>& p = figure->get_point(i);
+                min_x = std::min(min_x, p.getX());
+                max_x = std::max(max_x, p.getX());
+                min_y = std::min(min_y, p.getY());
+                max_y = std::max(max_y, p.getY());
+            }
+            found += min_x <= window.max.getX() && window.min.getX() <= max_x
+                  && min_y <= window.max.getY() && window.min.getY() <= max_y;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+BENCHMARK(BM_WindowQueryLinear)->RangeMultiplier(16)->Range(1 << 12, 1 << 20);
+
+void BM_NearestIndex(benchmark::State& state) {
+    const SpatialIndex<int> index(make_scattered_figures(static_cast<size_t>(state.range(0))));
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> coord(0, 100000);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.nearest(Point<int>(coord(rng), coord(rng)), 10).data());
+    }
+}
+BENCHMARK(BM_NearestIndex)->RangeMultiplier(16)->Range(1 << 12, 1 << 20);
+
+void BM_NearestLinear(benchmark::State& state) {
+    const auto figures = make_scattered_figures(static_cast<size_t>(state.range(0)));
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> coord(0, 100000);
+    Array<std::pair<double, size_t>> distances;
+    distances.resize(figures.size());
+    for (auto _ : state) {
+        const double x = coord(rng), y = coord(rng);
+        for (size_t i = 0; i < figures.size(); ++i) {
+            const Point<int> c = figures[i]->center();
+            distances[i] = {(c.getX() - x) * (c.getX() - x) + (c.getY() - y) * (c.getY() - y), i};
+        }
+        std::partial_sort(distances.begin(), distances.begin() + 10, distances.end());
+        benchmark::DoNotOptimize(distances.data());
+    }
+}
+BENCHMARK(BM_NearestLinear)->RangeMultiplier(16)->Range(1 << 12, 1 << 20);
+
+void BM_SpatialIndexInsert(benchmark::State& state) {
+    const auto figures = make_scattered_figures(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        SpatialIndex<int> index;
+        for (const auto& figure : figures) {
+            index.insert(figure);
+        }
+        benchmark::DoNotOptimize(&index);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SpatialIndexInsert)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+
+// ==================== Принадлежность точек ====================
+
+Array<Point<int>> make_query_points(size_t count) {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> coord(-20, 120);
+    Array<Point<int>> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        points.emplace_back(coord(rng), coord(rng));
+    }
+    return points;
+}
+
+template<class F>
+void BM_ContainsBatch(benchmark::State& state) {
+    Point<int> quad[] = {{0, 0}, {100, 0}, {100, 100}, {0, 100}};
+    Point<int> trap[] = {{0, 0}, {100, 0}, {70, 100}, {30, 100}};
+    const F figure(std::span<const Point<int>>(std::is_same_v<F, Trapezoid<int>> ? trap : quad));
+    const Array<Point<int>> points = make_query_points(static_cast<size_t>(state.range(0)));
+    Array<bool> out;
+    out.resize(points.size());
+    for (auto _ : state) {
+        figure.contains(std::span<const Point<int>>(points.data(), points.size()), std::span<bool>(out.data(), out.size()));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ContainsBatch, Square<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ContainsBatch, Trapezoid<int>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// Ядро проверки по многоугольнику на каждом наборе инструкций
+void BM_PolygonContains(benchmark::State& state) {
+    const auto level = simd::clamp_level(static_cast<simd::Level>(state.range(0)));
+    if (level != static_cast<simd::Level>(state.range(0))) {
+        state.SkipWithError("instruction set is not supported by this CPU");
+        return;
+    }
+    Point<int> trap[] = {{0, 0}, {100, 0}, {70, 100}, {30, 100}};
+    const Array<Point<int>> points = make_query_points(static_cast<size_t>(state.range(1)));
+    Array<bool> out;
+    out.resize(points.size());
+    for (auto _ : state) {
+        containment::polygon_contains(std::span<const Point<int>>(trap),
+                                      std::span<const Point<int>>(points.data(), points.size()), out.data(), level);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetLabel(simd::level_name(level));
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_PolygonContains)->ArgsProduct({
+    {static_cast<int>(simd::Level::Scalar), static_cast<int>(simd::Level::AVX2),
+     static_cast<int>(simd::Level::AVX512)},
+    {1 << 10, 1 << 16, 1 << 20}});
+
+// Поштучные вызовы для сравнения с пакетными
+void BM_ContainsSingle(benchmark::State& state) {
+    Point<int> trap[] = {{0, 0}, {100, 0}, {70, 100}, {30, 100}};
+    const Trapezoid<int> figure{std::span<const Point<int>>(trap)};
+    const Array<Point<int>> points = make_query_points(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        size_t inside = 0;
+        for (const Point<int>& point : points) {
+            inside += figure.contains(point);
+        }
+        benchmark::DoNotOptimize(inside);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ContainsSingle)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// ==================== Сортировка по площади ====================
+
+// Каждая итерация получает неотсортированную копию (копирование не замеряется)
+template<class Sort>
+void run_area_sort(benchmark::State& state, Sort sort) {
+    const Array<FigurePtr> figures = make_scattered_figures(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Array<FigurePtr> copy = figures;
+        state.ResumeTiming();
+        sort(copy);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+bool area_less(const FigurePtr& a, const FigurePtr& b) {
+    return static_cast<double>(*a) < static_cast<double>(*b);
+}
+
+void BM_SortByAreaStdSort(benchmark::State& state) {
+    run_area_sort(state, [](Array<FigurePtr>& figures) { std::sort(figures.begin(), figures.end(), area_less); });
+}
+BENCHMARK(BM_SortByAreaStdSort)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_SortByAreaRadix(benchmark::State& state) {
+    run_area_sort(state, [](Array<FigurePtr>& figures) { sort_by_area(figures); });
+}
+BENCHMARK(BM_SortByAreaRadix)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_SortByAreaRadixPool(benchmark::State& state) {
+    ThreadPool pool;
+    run_area_sort(state, [&](Array<FigurePtr>& figures) { sort_by_area(pool, figures); });
+}
+BENCHMARK(BM_SortByAreaRadixPool)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_TopKByAreaStdPartialSort(benchmark::State& state) {
+    run_area_sort(state, [](Array<FigurePtr>& figures) {
+        std::partial_sort(figures.begin(), figures.begin() + 100, figures.end(),
+                          [](const FigurePtr& a, const FigurePtr& b) { return area_less(b, a); });
+    });
+}
+BENCHMARK(BM_TopKByAreaStdPartialSort)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_TopKByArea(benchmark::State& state) {
+    run_area_sort(state, [](Array<FigurePtr>& figures) {
+        Array<FigurePtr> top = top_k_by_area(figures, 100);
+        benchmark::DoNotOptimize(top.data());
+    });
+}
+BENCHMARK(BM_TopKByArea)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_NthElementByAreaStd(benchmark::State& state) {
+    run_area_sort(state, [](Array<FigurePtr>& figures) {
+        std::nth_element(figures.begin(), figures.begin() + figures.size() / 2, figures.end(), area_less);
+    });
+}
+BENCHMARK(BM_NthElementByAreaStd)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_NthElementByArea(benchmark::State& state) {
+    run_area_sort(state, [](Array<FigurePtr>& figures) { nth_element_by_area(figures, figures.size() / 2); });
+}
+BENCHMARK(BM_NthElementByArea)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+
+// ==================== Параллельное добавление ====================
+
+// state.range(0) потоков-производителей добавляют 1 млн разных фигур
+// (копии shared_ptr без общих счётчиков ссылок), затем freeze()
+template<class Append>
+void run_producers(benchmark::State& state, Append append) {
+    const size_t threads = static_cast<size_t>(state.range(0));
+    const Array<FigurePtr> figures = make_mixed_figures(1 << 20);
+    for (auto _ : state) {
+        std::vector<std::thread> producers;
+        for (size_t t = 0; t < threads; ++t) {
+            producers.emplace_back([&, t] {
+                const size_t begin = figures.size() * t / threads;
+                const size_t end = figures.size() * (t + 1) / threads;
+                for (size_t i = begin; i < end; ++i) {
+                    append(figures.unchecked(i));
+                }
+            });
+        }
+        for (auto& producer : producers) producer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(figures.size()));
+}
+
+void BM_AppendMutexArray(benchmark::State& state) {
+    std::mutex mutex;
+    Array<FigurePtr> result;
+    run_producers(state, [&](const FigurePtr& figure) {
+        std::lock_guard<std::mutex> lock(mutex);
+        result.push_back(figure);
+    });
+    benchmark::DoNotOptimize(result.data());
+}
+BENCHMARK(BM_AppendMutexArray)->RangeMultiplier(2)->Range(1, 32)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+void BM_AppendConcurrentArray(benchmark::State& state) {
+    ConcurrentArray<FigurePtr> result;
+    run_producers(state, [&](const FigurePtr& figure) { result.push_back(figure); });
+    Array<FigurePtr> frozen = result.freeze();
+    benchmark::DoNotOptimize(frozen.data());
+}
+BENCHMARK(BM_AppendConcurrentArray)->RangeMultiplier(2)->Range(1, 32)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// freeze() 1 млн фигур: с ожидаемым размером (первый сегмент отдаётся
+// без копирования) и без него (перенос сегментов memcpy). Заполнение
+// не замеряется, поэтому число итераций задано явно
+void BM_ConcurrentArrayFreeze(benchmark::State& state) {
+    const Array<FigurePtr> figures = make_mixed_figures(1 << 20);
+    for (auto _ : state) {
+        state.PauseTiming();
+        ConcurrentArray<FigurePtr> arr(state.range(0) ? figures.size() : ConcurrentArray<FigurePtr>::default_first_capacity);
+        for (const FigurePtr& figure : figures) {
+            arr.push_back(figure);
+        }
+        state.ResumeTiming();
+        Array<FigurePtr> frozen = arr.freeze();
+        benchmark::DoNotOptimize(frozen.data());
+        state.PauseTiming();
+        frozen.clear();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_ConcurrentArrayFreeze)->Arg(0)->Arg(1)->Iterations(20)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+// ==================== Многоугольники и выпуклая оболочка ====================
+
+// Правильный многоугольник с заданным числом вершин
+void BM_PolygonCentroid(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    Array<Point<int>> vertices;
+    vertices.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const double angle = 6.283185307179586 * static_cast<double>(i) / static_cast<double>(count);
+        vertices.push_back(Point<int>(static_cast<int>(1e6 * std::cos(angle)), static_cast<int>(1e6 * std::sin(angle))));
+    }
+    const PolygonFigure<int> polygon(std::span<const Point<int>>(vertices.data(), vertices.size()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.centroid());
+        benchmark::DoNotOptimize(polygon.perimeter());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolygonCentroid)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+Array<Point<int>> make_hull_points(size_t count) {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> coord(-1000000, 1000000);
+    Array<Point<int>> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        points.push_back(Point<int>(coord(rng), coord(rng)));
+    }
+    return points;
+}
+
+void BM_ConvexHull(benchmark::State& state) {
+    const Array<Point<int>> points = make_hull_points(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convex_hull(std::span<const Point<int>>(points.data(), points.size())));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvexHull)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)->Unit(benchmark::kMillisecond);
+
+void BM_ConvexHullParallel(benchmark::State& state) {
+    const Array<Point<int>> points = make_hull_points(static_cast<size_t>(state.range(0)));
+    ThreadPool pool;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convex_hull(pool, std::span<const Point<int>>(points.data(), points.size())));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvexHullParallel)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ==================== Аффинные преобразования ====================
+
+using PolygonPtr = std::shared_ptr<Figure<double>>;
+
+// 16 384 многоугольника по vertices вершин
+Array<PolygonPtr> make_polygons(size_t vertices) {
+    Array<PolygonPtr> figures;
+    figures.reserve(1 << 14);
+    Array<Point<double>> points;
+    for (size_t f = 0; f < (1 << 14); ++f) {
+        points.clear();
+        for (size_t v = 0; v < vertices; ++v) {
+            const double angle = 6.283185307179586 * static_cast<double>(v) / static_cast<double>(vertices);
+            points.push_back(Point<double>(static_cast<double>(f) + std::cos(angle), std::sin(angle)));
+        }
+        figures.push_back(std::make_shared<PolygonFigure<double>>(std::span<const Point<double>>(points.data(), points.size())));
+    }
+    return figures;
+}
+
+// Прежний способ: новая фигура из преобразованных точек
+void BM_TransformRebuild(benchmark::State& state) {
+    auto figures = make_polygons(static_cast<size_t>(state.range(0)));
+    const AffineTransform m = AffineTransform::rotation(0.001);
+    Array<Point<double>> points;
+    for (auto _ : state) {
+        for (auto& figure : figures) {
+            (void)figure->area();
+            points.clear();
+            for (size_t v = 0; v < figure->get_points_count(); ++v) {
+                points.push_back(m.apply(figure->get_point(v)));
+            }
+            figure = make_figure<double>(figure->kind(), std::span<const Point<double>>(points.data(), points.size()));
+        }
+        benchmark::DoNotOptimize(figures.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * (1 << 14));
+}
+BENCHMARK(BM_TransformRebuild)->Arg(4)->Arg(64)->Unit(benchmark::kMillisecond);
+
+// Вершины на месте, площадь из кэша умножается на |det|
+void BM_TransformInPlace(benchmark::State& state) {
+    Array<PolygonPtr> figures = make_polygons(static_cast<size_t>(state.range(0)));
+    const AffineTransform m = AffineTransform::rotation(0.001);
+    for (auto _ : state) {
+        for (const auto& figure : figures) {
+            (void)figure->area();
+        }
+        transform_figures(figures, m);
+        benchmark::DoNotOptimize(figures.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * (1 << 14));
+}
+BENCHMARK(BM_TransformInPlace)->Arg(4)->Arg(64)->Unit(benchmark::kMillisecond);
+
+// Ядро на каждом наборе инструкций
+template<class T>
+void BM_TransformKernel(benchmark::State& state) {
+    const auto level = simd::clamp_level(static_cast<simd::Level>(state.range(0)));
+    if (level != static_cast<simd::Level>(state.range(0))) {
+        state.SkipWithError("instruction set is not supported by this CPU");
+        return;
+    }
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int> coord(-100000, 100000);
+    Array<Point<T>> points;
+    for (int64_t i = 0; i < state.range(1); ++i) {
+        points.push_back(Point<T>(static_cast<T>(coord(rng)), static_cast<T>(coord(rng))));
+    }
+    const AffineTransform m = AffineTransform::rotation(0.001);
+    for (auto _ : state) {
+        affine::transform_points(m, points.data(), points.size(), level);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetLabel(simd::level_name(level));
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK_TEMPLATE(BM_TransformKernel, double)->ArgsProduct({
+    {static_cast<int>(simd::Level::Scalar), static_cast<int>(simd::Level::AVX2),
+     static_cast<int>(simd::Level::AVX512)},
+    {1 << 10, 1 << 16, 1 << 20}});
+BENCHMARK_TEMPLATE(BM_TransformKernel, int)->ArgsProduct({
+    {static_cast<int>(simd::Level::Scalar), static_cast<int>(simd::Level::AVX2),
+     static_cast<int>(simd::Level::AVX512)},
+    {1 << 10, 1 << 16, 1 << 20}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,190 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include "point.h"
+#include "simd_kernels.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FIGURES_AFFINE_INLINE inline __attribute__((always_inline))
+#else
+#define FIGURES_AFFINE_INLINE inline
+#endif
+
+// Аффинное преобразование плоскости:
+//
+//     x' = a * x + b * y + tx
+//     y' = c * x + d * y + ty
+//
+// Вычисления идут в double; для целых координат результат округляется
+// к ближайшему целому (половины — вверх) и должен помещаться в T.
+struct AffineTransform {
+    double a = 1.0, b = 0.0, tx = 0.0;
+    double c = 0.0, d = 1.0, ty = 0.0;
+
+    static AffineTransform translation(double dx, double dy) { return {1.0, 0.0, dx, 0.0, 1.0, dy}; }
+    static AffineTransform scaling(double sx, double sy) { return {sx, 0.0, 0.0, 0.0, sy, 0.0}; }
+    static AffineTransform scaling(double s) { return scaling(s, s); }
+
+    // Поворот против часовой стрелки вокруг начала координат
+    static AffineTransform rotation(double radians) {
+        const double cos = std::cos(radians), sin = std::sin(radians);
+        return {cos, -sin, 0.0, sin, cos, 0.0};
+    }
+
+    // Поворот вокруг точки pivot
+    static AffineTransform rotation(double radians, const Point<double>& pivot) {
+        return translation(pivot.getX(), pivot.getY()) * rotation(radians)
+             * translation(-pivot.getX(), -pivot.getY());
+    }
+
+    // Площадь любой фигуры умножается на |determinant()|
+    double determinant() const noexcept { return a * d - b * c; }
+
+    // Стороны, параллельные осям, остаются параллельными осям: габарит
+    // переходит в габарит
+    bool preserves_axes() const noexcept { return b == 0.0 && c == 0.0; }
+
+    // Целые точки переходят в целые без округления
+    bool has_integer_coefficients() const noexcept {
+        auto integer = [](double value) { return std::floor(value) == value; };
+        return integer(a) && integer(b) && integer(c) && integer(d) && integer(tx) && integer(ty);
+    }
+
+    template<class T>
+    Point<T> apply(const Point<T>& point) const;
+
+    // Композиция: сначала rhs, затем lhs
+    friend AffineTransform operator*(const AffineTransform& lhs, const AffineTransform& rhs) noexcept {
+        return {lhs.a * rhs.a + lhs.b * rhs.c, lhs.a * rhs.b + lhs.b * rhs.d, lhs.a * rhs.tx + lhs.b * rhs.ty + lhs.tx,
+                lhs.c * rhs.a + lhs.d * rhs.c, lhs.c * rhs.b + lhs.d * rhs.d, lhs.c * rhs.tx + lhs.d * rhs.ty + lhs.ty};
+    }
+};
+
+// Пакетное преобразование координат на месте. Точки обрабатываются
+// блоками, как в containment.h: координаты блока раскладываются в массивы
+// double, преобразование и округление идут по ним без ветвлений — такие
+// циклы компилятор векторизует. Вариант для AVX2 / AVX-512 выбирается при
+// запуске; FMA отключено, поэтому все варианты совпадают с apply() бит в бит.
+namespace affine {
+
+inline constexpr size_t block_size = 64;
+
+template<class T>
+FIGURES_AFFINE_INLINE T from_double(double value) {
+    if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(std::floor(value + 0.5));
+    } else {
+        return static_cast<T>(value);
+    }
+}
+
+FIGURES_AFFINE_INLINE void transform_block(const AffineTransform& m, double* px, double* py, size_t count) {
+    for (size_t k = 0; k < count; ++k) {
+        const double x = px[k], y = py[k];
+        px[k] = m.a * x + m.b * y + m.tx;
+        py[k] = m.c * x + m.d * y + m.ty;
+    }
+}
+
+// Вершины подряд: Point<T>[count]
+template<class T>
+FIGURES_AFFINE_INLINE void transform_points_blocks(const AffineTransform& m, Point<T>* points, size_t count) {
+    double px[block_size], py[block_size];
+    for (size_t begin = 0; begin < count; begin += block_size) {
+        const size_t n = std::min(block_size, count - begin);
+        Point<T>* block = points + begin;
+        for (size_t k = 0; k < n; ++k) {
+            px[k] = static_cast<double>(block[k].getX());
+            py[k] = static_cast<double>(block[k].getY());
+        }
+        transform_block(m, px, py, n);
+        for (size_t k = 0; k < n; ++k) {
+            block[k] = Point<T>(from_double<T>(px[k]), from_double<T>(py[k]));
+        }
+    }
+}
+
+// Координаты столбцами: xs[count], ys[count]
+template<class T>
+FIGURES_AFFINE_INLINE void transform_columns_blocks(const AffineTransform& m, T* xs, T* ys, size_t count) {
+    double px[block_size], py[block_size];
+    for (size_t begin = 0; begin < count; begin += block_size) {
+        const size_t n = std::min(block_size, count - begin);
+        for (size_t k = 0; k < n; ++k) {
+            px[k] = static_cast<double>(xs[begin + k]);
+            py[k] = static_cast<double>(ys[begin + k]);
+        }
+        transform_block(m, px, py, n);
+        for (size_t k = 0; k < n; ++k) {
+            xs[begin + k] = from_double<T>(px[k]);
+            ys[begin + k] = from_double<T>(py[k]);
+        }
+    }
+}
+
+#ifdef FIGURES_SIMD_X86
+template<class T>
+FIGURES_SIMD_TARGET("avx2")
+void transform_points_avx2(const AffineTransform& m, Point<T>* points, size_t count) {
+    transform_points_blocks(m, points, count);
+}
+
+template<class T>
+FIGURES_SIMD_TARGET("avx512f")
+void transform_points_avx512(const AffineTransform& m, Point<T>* points, size_t count) {
+    transform_points_blocks(m, points, count);
+}
+
+template<class T>
+FIGURES_SIMD_TARGET("avx2")
+void transform_columns_avx2(const AffineTransform& m, T* xs, T* ys, size_t count) {
+    transform_columns_blocks(m, xs, ys, count);
+}
+
+template<class T>
+FIGURES_SIMD_TARGET("avx512f")
+void transform_columns_avx512(const AffineTransform& m, T* xs, T* ys, size_t count) {
+    transform_columns_blocks(m, xs, ys, count);
+}
+#endif
+
+template<class T>
+void transform_points(const AffineTransform& m, Point<T>* points, size_t count,
+                      simd::Level level = simd::active_level()) {
+#ifdef FIGURES_SIMD_X86
+    switch (simd::clamp_level(level)) {
+        case simd::Level::AVX512: return transform_points_avx512(m, points, count);
+        case simd::Level::AVX2: return transform_points_avx2(m, points, count);
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    transform_points_blocks(m, points, count);
+}
+
+template<class T>
+void transform_columns(const AffineTransform& m, T* xs, T* ys, size_t count,
+                       simd::Level level = simd::active_level()) {
+#ifdef FIGURES_SIMD_X86
+    switch (simd::clamp_level(level)) {
+        case simd::Level::AVX512: return transform_columns_avx512(m, xs, ys, count);
+        case simd::Level::AVX2: return transform_columns_avx2(m, xs, ys, count);
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    transform_columns_blocks(m, xs, ys, count);
+}
+
+} // namespace affine
+
+template<class T>
+Point<T> AffineTransform::apply(const Point<T>& point) const {
+    double x = static_cast<double>(point.getX()), y = static_cast<double>(point.getY());
+    affine::transform_block(*this, &x, &y, 1);
+    return Point<T>(affine::from_double<T>(x), affine::from_double<T>(y));
+}
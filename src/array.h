@@ -1,107 +1,469 @@
 #pragma once
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <utility>
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <stdexcept>
 #include <type_traits>
+#include "instrumentation.h"
 
+// Элементы создаются на месте в сырой памяти, поэтому конструктор
+// по умолчанию не требуется
 template <typename T>
-concept Arrayable = std::is_default_constructible_v<T>;
+concept Arrayable = std::is_nothrow_destructible_v<T>
+    && (std::is_move_constructible_v<T> || std::is_copy_constructible_v<T>);
 
-template <Arrayable T>
+// Тип можно перенести в другую память побайтно (memcpy) вместо перемещения
+// с уничтожением исходного объекта. По умолчанию — тривиально копируемые
+// типы; остальные подключаются специализацией, если объект не хранит
+// указателей на самого себя
+template <class T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <class T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <class T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+template <class T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <class T>
+struct is_trivially_relocatable<std::allocator<T>> : std::true_type {};
+
+template <class T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+template <class T>
+class ConcurrentArray;
+
+// Alloc — стандартный аллокатор (std::allocator, std::pmr::polymorphic_allocator
+// и т.п.). Элементы строятся через allocator_traits, поэтому вложенные
+// контейнеры с pmr-аллокатором получают тот же ресурс памяти
+template <Arrayable T, class Alloc = std::allocator<T>>
 class Array {
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    static constexpr bool relocatable = is_trivially_relocatable_v<T>;
+    // Сдвиг элементов внутри массива: побайтно или перемещающим присваиванием
+    static constexpr bool shiftable = relocatable || std::is_move_assignable_v<T>;
+
 public:
-    Array() noexcept : _size(0), _capacity(0), _data(nullptr) {}
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    // Элементы лежат подряд, поэтому указатель — полноценный contiguous-итератор
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr double default_growth_factor = 2.0;
+
+    Array() noexcept(noexcept(Alloc())) : Array(Alloc()) {}
+
+    explicit Array(const Alloc& alloc) noexcept : _size(0), _capacity(0), _data(nullptr), _alloc(alloc) {}
 
     // Копирующий конструктор
-    Array(const Array& other) : _size(other._size), _capacity(other._capacity) {
-        if (_capacity) {
-            _data = std::make_unique<T[]>(_capacity);
-            for (size_t i = 0; i < _size; ++i) _data[i] = other._data[i];
+    Array(const Array& other)
+        : Array(other, alloc_traits::select_on_container_copy_construction(other._alloc)) {}
+
+    Array(const Array& other, const Alloc& alloc) : Array(alloc) {
+        FIGURES_COUNT(Array, copies, 1);
+        _growth_factor = other._growth_factor;
+        if (other._size) {
+            T* new_data = allocate(other._size);
+            try {
+                construct_range(other._data, other._size, new_data);
+            } catch (...) {
+                deallocate(new_data, other._size);
+                throw;
+            }
+            _data = new_data;
+            _size = _capacity = other._size;
         }
     }
 
     Array& operator=(const Array& other) {
         if (this == &other) return *this;
-        Array tmp(other);
-        swap(tmp);
+        constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+        Array tmp(other, propagate ? other._alloc : _alloc);
+        swap_storage(tmp);
+        if constexpr (propagate) {
+            std::swap(_alloc, tmp._alloc);
+        }
         return *this;
     }
 
-    Array(Array&& other) noexcept : _size(other._size), _capacity(other._capacity), _data(std::move(other._data)) {
+    Array(Array&& other) noexcept
+        : _size(other._size), _capacity(other._capacity), _data(other._data),
+          _growth_factor(other._growth_factor), _alloc(std::move(other._alloc)) {
+        FIGURES_COUNT(Array, moves, 1);
         other._size = 0;
         other._capacity = 0;
+        other._data = nullptr;
+    }
+
+    // При разных ресурсах памяти элементы перемещаются поштучно
+    Array(Array&& other, const Alloc& alloc) : Array(alloc) {
+        FIGURES_COUNT(Array, moves, 1);
+        _growth_factor = other._growth_factor;
+        if (_alloc == other._alloc) {
+            swap_storage(other);
+        } else if (other._size) {
+            reserve(other._size);
+            construct_range(std::make_move_iterator(other._data), other._size, _data);
+            _size = other._size;
+            other.clear();
+        }
     }
 
     // Перемещающий оператор присваивания
-    Array& operator=(Array&& other) noexcept {
+    Array& operator=(Array&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value
+                                             || alloc_traits::is_always_equal::value) {
         if (this == &other) return *this;
-        _size = other._size;
-        _capacity = other._capacity;
-        _data = std::move(other._data);
-        other._size = other._capacity = 0;
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            Array tmp(std::move(other));
+            swap_storage(tmp);
+            std::swap(_alloc, tmp._alloc);
+        } else {
+            Array tmp(std::move(other), _alloc);
+            swap_storage(tmp);
+        }
         return *this;
     }
 
-    ~Array() = default;
+    ~Array() {
+        clear();
+        deallocate(_data, _capacity);
+    }
+
+    allocator_type get_allocator() const noexcept { return _alloc; }
 
     T& operator[](size_t idx) {
-        if (idx >= _size) throw std::out_of_range("Array index out of range");
+        if (idx >= _size) out_of_range();
         return _data[idx];
     }
     const T& operator[](size_t idx) const {
-        if (idx >= _size) throw std::out_of_range("Array index out of range");
+        if (idx >= _size) out_of_range();
         return _data[idx];
     }
 
+    // Доступ без проверки границ для горячих циклов
+    T& unchecked(size_t idx) noexcept { return _data[idx]; }
+    const T& unchecked(size_t idx) const noexcept { return _data[idx]; }
+
+    T* data() noexcept { return _data; }
+    const T* data() const noexcept { return _data; }
+
+    iterator begin() noexcept { return _data; }
+    iterator end() noexcept { return _data + _size; }
+    const_iterator begin() const noexcept { return _data; }
+    const_iterator end() const noexcept { return _data + _size; }
+    const_iterator cbegin() const noexcept { return _data; }
+    const_iterator cend() const noexcept { return _data + _size; }
+
     size_t size() const noexcept {return _size;}
     size_t capacity() const noexcept {return _capacity;}
     bool empty() const noexcept {return _size == 0;}
 
+    // Строгая гарантия: при исключении массив остаётся прежним
     void reserve(size_t new_capacity) {
         if (new_capacity <= _capacity) return;
-        std::unique_ptr<T[]> new_data = std::make_unique<T[]>(new_capacity);
-        for (size_t i = 0; i < _size; ++i) {
-            new_data[i] = std::move(_data[i]);
+        reallocate(new_capacity);
+    }
+
+    // Освобождает лишнюю ёмкость (строгая гарантия, как у reserve)
+    void shrink_to_fit() {
+        if (_capacity == _size) return;
+        if (_size == 0) {
+            deallocate(_data, _capacity);
+            _data = nullptr;
+            _capacity = 0;
+            return;
         }
-        _data = std::move(new_data);
-        _capacity = new_capacity;
+        reallocate(_size);
     }
 
-    void resize(size_t new_size) {
+    // Во сколько раз растёт ёмкость, когда место кончается. Настройка
+    // самого массива: переходит в копии и при перемещении-конструировании,
+    // но не при присваивании и swap
+    double growth_factor() const noexcept { return _growth_factor; }
+
+    void set_growth_factor(double factor) {
+        if (!(factor > 1.0) || !std::isfinite(factor)) {
+            throw std::invalid_argument("Growth factor must be greater than 1");
+        }
+        _growth_factor = factor;
+    }
+
+    // Новые элементы инициализируются значением, лишние уничтожаются
+    void resize(size_t new_size) requires std::is_default_constructible_v<T> {
+        if (new_size < _size) {
+            destroy_range(_data + new_size, _size - new_size);
+            _size = new_size;
+            return;
+        }
         if (new_size > _capacity) {
-            reserve(new_size);
+            reserve(std::max(new_size, grow_capacity()));
+        }
+        for (; _size < new_size; ++_size) {
+            alloc_traits::construct(_alloc, _data + _size);
         }
-        _size = new_size;
     }
 
     void clear() noexcept {
+        destroy_range(_data, _size);
         _size = 0;
     }
 
-    void pop_back() {
+    void pop_back() noexcept {
         if (_size == 0) return;
         --_size;
+        alloc_traits::destroy(_alloc, _data + _size);
     }
 
-    void push_back(const T& value) {
-        if (_size == _capacity) reserve(std::max<size_t>(1, _capacity * 2));
-        _data[_size++] = value; 
+    void push_back(const T& value) requires std::is_copy_constructible_v<T> {
+        emplace_back(value);
     }
 
     void push_back(T&& value) {
-        if (_size == _capacity) reserve(std::max<size_t>(1, _capacity * 2));
-        _data[_size++] = std::move(value);
+        emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        if (_size < _capacity) {
+            alloc_traits::construct(_alloc, _data + _size, std::forward<Args>(args)...);
+            return _data[_size++];
+        }
+
+        // Новый элемент строится первым: args могут ссылаться на элементы массива
+        size_t new_capacity = grow_capacity();
+        T* new_data = allocate(new_capacity);
+        try {
+            alloc_traits::construct(_alloc, new_data + _size, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(new_data, new_capacity);
+            throw;
+        }
+        try {
+            relocate(_data, _size, new_data);
+        } catch (...) {
+            alloc_traits::destroy(_alloc, new_data + _size);
+            deallocate(new_data, new_capacity);
+            throw;
+        }
+        replace_storage(new_data, new_capacity);
+        return _data[_size++];
+    }
+
+    // Вставка перед pos; возвращает итератор на новый элемент. Остальные
+    // элементы сдвигаются на одну позицию (для тривиально переносимых
+    // типов — одним memmove). При нехватке места гарантия строгая, иначе
+    // базовая, как у std::vector
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args) requires shiftable {
+        const size_t idx = static_cast<size_t>(pos - _data);
+        if (idx > _size) out_of_range();
+        if (idx == _size) {
+            emplace_back(std::forward<Args>(args)...);
+            return _data + idx;
+        }
+
+        if (_size == _capacity) {
+            // Как в emplace_back: args могут ссылаться на элементы массива
+            size_t new_capacity = grow_capacity();
+            T* new_data = allocate(new_capacity);
+            try {
+                alloc_traits::construct(_alloc, new_data + idx, std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(new_data, new_capacity);
+                throw;
+            }
+            try {
+                relocate(_data, idx, new_data);
+                try {
+                    relocate(_data + idx, _size - idx, new_data + idx + 1);
+                } catch (...) {
+                    destroy_range(new_data, idx);
+                    throw;
+                }
+            } catch (...) {
+                alloc_traits::destroy(_alloc, new_data + idx);
+                deallocate(new_data, new_capacity);
+                throw;
+            }
+            replace_storage(new_data, new_capacity);
+            ++_size;
+            return _data + idx;
+        }
+
+        // Элемент строится в свободной ячейке за концом и сдвигается на место
+        alloc_traits::construct(_alloc, _data + _size, std::forward<Args>(args)...);
+        ++_size;
+        if constexpr (relocatable) {
+            alignas(T) unsigned char last[sizeof(T)];
+            std::memcpy(last, static_cast<const void*>(_data + _size - 1), sizeof(T));
+            std::memmove(static_cast<void*>(_data + idx + 1), static_cast<const void*>(_data + idx),
+                         (_size - 1 - idx) * sizeof(T));
+            std::memcpy(static_cast<void*>(_data + idx), last, sizeof(T));
+        } else {
+            std::rotate(_data + idx, _data + _size - 1, _data + _size);
+        }
+        return _data + idx;
+    }
+
+    iterator insert(const_iterator pos, const T& value) requires shiftable && std::is_copy_constructible_v<T> {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value) requires shiftable {
+        return emplace(pos, std::move(value));
+    }
+
+    // Удаляет [first, last) и возвращает итератор на следующий за ними элемент
+    iterator erase(const_iterator first, const_iterator last) requires shiftable {
+        const size_t begin = static_cast<size_t>(first - _data);
+        const size_t end = static_cast<size_t>(last - _data);
+        if (begin > end || end > _size) out_of_range();
+        const size_t count = end - begin;
+        if (count == 0) return _data + begin;
+        if constexpr (relocatable) {
+            destroy_range(_data + begin, count);
+            std::memmove(static_cast<void*>(_data + begin), static_cast<const void*>(_data + end),
+                         (_size - end) * sizeof(T));
+        } else {
+            std::move(_data + end, _data + _size, _data + begin);
+            destroy_range(_data + _size - count, count);
+        }
+        _size -= count;
+        return _data + begin;
+    }
+
+    iterator erase(const_iterator pos) requires shiftable {
+        return erase(pos, pos + 1);
     }
 
+    // Аллокаторы обмениваются, только если этого требует propagate_on_container_swap
     void swap(Array& other) noexcept {
+        swap_storage(other);
+        if constexpr (alloc_traits::propagate_on_container_swap::value) {
+            std::swap(_alloc, other._alloc);
+        }
+    }
+
+private:
+    template <class>
+    friend class ConcurrentArray;
+
+    // Принимает готовый буфер из alloc: size построенных элементов, ёмкость capacity
+    Array(T* data, size_t size, size_t capacity, const Alloc& alloc) noexcept
+        : _size(size), _capacity(capacity), _data(data), _alloc(alloc) {}
+
+    [[noreturn]] static void out_of_range() {
+        FIGURES_COUNT(Array, bounds_failures, 1);
+        throw std::out_of_range("Array index out of range");
+    }
+
+    T* allocate(size_t count) {
+        FIGURES_COUNT(Array, allocations, 1);
+        FIGURES_COUNT(Array, bytes, count * sizeof(T));
+        return alloc_traits::allocate(_alloc, count);
+    }
+
+    void deallocate(T* ptr, size_t count) noexcept {
+        if (ptr) alloc_traits::deallocate(_alloc, ptr, count);
+    }
+
+    // Не меньше чем на один элемент: при малой ёмкости произведение
+    // может округлиться до прежнего значения
+    size_t grow_capacity() const noexcept {
+        return std::max(_capacity + 1, static_cast<size_t>(static_cast<double>(_capacity) * _growth_factor));
+    }
+
+    void reallocate(size_t new_capacity) {
+        T* new_data = allocate(new_capacity);
+        try {
+            relocate(_data, _size, new_data);
+        } catch (...) {
+            deallocate(new_data, new_capacity);
+            throw;
+        }
+        replace_storage(new_data, new_capacity);
+    }
+
+    // Строит count элементов из first в сырой памяти to; при исключении
+    // уже построенные элементы уничтожаются
+    template <class It>
+    void construct_range(It first, size_t count, T* to) {
+        size_t built = 0;
+        try {
+            for (; built < count; ++built, ++first) {
+                alloc_traits::construct(_alloc, to + built, *first);
+            }
+        } catch (...) {
+            destroy_range(to, built);
+            throw;
+        }
+    }
+
+    void destroy_range(T* first, size_t count) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < count; ++i) {
+                alloc_traits::destroy(_alloc, first + i);
+            }
+        }
+    }
+
+    // Тривиально переносимые типы копируются одним memcpy, а старые объекты
+    // не уничтожаются (см. replace_storage). Остальные перемещаются, если
+    // перемещение не бросает, иначе копируются (как в std::vector)
+    void relocate(T* from, size_t count, T* to) {
+        FIGURES_COUNT(Array, relocated, count);
+        if constexpr (relocatable) {
+            if (count) std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            construct_range(std::make_move_iterator(from), count, to);
+        } else {
+            construct_range(from, count, to);
+        }
+    }
+
+    // Вызывается после relocate всех _size элементов в new_data
+    void replace_storage(T* new_data, size_t new_capacity) noexcept {
+        FIGURES_COUNT(Array, reallocations, 1);
+        if constexpr (!relocatable) destroy_range(_data, _size);
+        deallocate(_data, _capacity);
+        _data = new_data;
+        _capacity = new_capacity;
+    }
+
+    void swap_storage(Array& other) noexcept {
         std::swap(_size, other._size);
         std::swap(_capacity, other._capacity);
         std::swap(_data, other._data);
     }
 
-private:
     size_t _size;
     size_t _capacity;
-    std::unique_ptr<T[]> _data;
-};
\ No newline at end of file
+    T* _data;
+    double _growth_factor = default_growth_factor;
+    [[no_unique_address]] Alloc _alloc;
+};
+
+// Массив не хранит указателей на себя: переносим, если переносим аллокатор
+template <Arrayable T, class Alloc>
+struct is_trivially_relocatable<Array<T, Alloc>> : is_trivially_relocatable<Alloc> {};
+
+// Массив, память которого выдаёт std::pmr::memory_resource (например, арена)
+template <Arrayable T>
+using PmrArray = Array<T, std::pmr::polymorphic_allocator<T>>;
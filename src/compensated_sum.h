@@ -0,0 +1,24 @@
+#pragma once
+#include <cmath>
+
+// Сумма Ноймайера: ошибка округления каждого сложения копится отдельно,
+// поэтому длинные серии прибавлений и вычитаний не уводят сумму.
+// Для inf и NaN поправка не считается: inf - inf сделал бы её NaN.
+// Вычесть inf обратно нельзя — для этого сумму нужно собрать заново.
+class CompensatedSum {
+public:
+    void add(double value) noexcept {
+        const double sum = _sum + value;
+        if (std::isfinite(sum)) {
+            _compensation += std::abs(_sum) >= std::abs(value) ? (_sum - sum) + value
+                                                               : (value - sum) + _sum;
+        }
+        _sum = sum;
+    }
+
+    double value() const noexcept { return std::isfinite(_sum) ? _sum + _compensation : _sum; }
+
+private:
+    double _sum = 0.0;
+    double _compensation = 0.0;
+};
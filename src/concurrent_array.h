@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array.h"
+
+// Массив только для добавления, в который пишут несколько потоков сразу.
+// push_back без блокировок: номер слота выдаёт атомарный fetch_add,
+// элемент строится в своём слоте. Память выделяется сегментами:
+// сегмент 0 — first_capacity элементов, сегмент k — first_capacity << (k - 1),
+// так что k + 1 сегментов вмещают first_capacity << k элементов. Сегменты
+// не перемещаются: ссылки на элементы действительны до freeze() или clear().
+//
+// Новый сегмент выделяет первый дошедший до него поток; если его
+// одновременно выделили несколько потоков, лишние буферы освобождаются.
+// Элемент, добавленный другим потоком, можно читать только после
+// синхронизации с ним (например, join). freeze() и clear() вызываются,
+// когда добавления закончены.
+template <class T>
+class ConcurrentArray {
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>,
+                  "ConcurrentArray requires nothrow move construction and destruction");
+
+public:
+    static constexpr size_t default_first_capacity = 1024;
+
+    // expected — ожидаемое число элементов (округляется вверх до степени
+    // двойки): если оно не превышено, freeze() отдаёт первый сегмент без копирования
+    explicit ConcurrentArray(size_t expected = default_first_capacity)
+        : _first_shift(static_cast<size_t>(std::bit_width(std::max<size_t>(expected, 1) - 1))) {}
+
+    ~ConcurrentArray() { clear(); }
+
+    ConcurrentArray(const ConcurrentArray&) = delete;
+    ConcurrentArray& operator=(const ConcurrentArray&) = delete;
+
+    void push_back(const T& value) requires std::is_copy_constructible_v<T> {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    // Значение строится до захвата слота: исключение из конструктора
+    // не оставляет в массиве пропусков
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        T value(std::forward<Args>(args)...);
+        const size_t index = _size.fetch_add(1, std::memory_order_relaxed);
+        const size_t segment = segment_of(index);
+        T* slot = acquire_segment(segment) + (index - segment_start(segment));
+        return *std::construct_at(slot, std::move(value));
+    }
+
+    // Число захваченных слотов; пока идут добавления, часть из них может
+    // быть ещё не построена
+    size_t size() const noexcept { return _size.load(std::memory_order_acquire); }
+    bool empty() const noexcept { return size() == 0; }
+
+    T& operator[](size_t idx) { return *slot(idx); }
+    const T& operator[](size_t idx) const { return *slot(idx); }
+
+    // Переносит элементы в обычный Array в порядке индексов и оставляет
+    // массив пустым. Если элементы уместились в первый сегмент, его буфер
+    // становится буфером Array без копирования; иначе сегменты переносятся
+    // в один буфер (тривиально переносимые — одним memcpy на сегмент)
+    Array<T> freeze() {
+        const size_t count = size();
+        if (count == 0) {
+            clear();
+            return Array<T>();
+        }
+        const size_t used = segment_of(count - 1) + 1;
+        if (used == 1) {
+            T* data = _segments[0].exchange(nullptr, std::memory_order_acquire);
+            _size.store(0, std::memory_order_release);
+            return Array<T>(data, count, segment_capacity(0), std::allocator<T>());
+        }
+
+        std::allocator<T> alloc;
+        T* data = alloc.allocate(count);
+        for (size_t segment = 0; segment < used; ++segment) {
+            T* from = _segments[segment].exchange(nullptr, std::memory_order_acquire);
+            const size_t start = segment_start(segment);
+            const size_t filled = std::min(count - start, segment_capacity(segment));
+            if constexpr (is_trivially_relocatable_v<T>) {
+                std::memcpy(static_cast<void*>(data + start), static_cast<const void*>(from), filled * sizeof(T));
+            } else {
+                for (size_t i = 0; i < filled; ++i) {
+                    std::construct_at(data + start + i, std::move(from[i]));
+                    std::destroy_at(from + i);
+                }
+            }
+            deallocate(from, segment_capacity(segment));
+        }
+        _size.store(0, std::memory_order_release);
+        return Array<T>(data, count, count, alloc);
+    }
+
+    void clear() noexcept {
+        const size_t count = size();
+        for (size_t segment = 0; segment < max_segments; ++segment) {
+            T* data = _segments[segment].exchange(nullptr, std::memory_order_acquire);
+            if (!data) continue;
+            const size_t start = segment_start(segment);
+            if (start < count) {
+                std::destroy_n(data, std::min(count - start, segment_capacity(segment)));
+            }
+            deallocate(data, segment_capacity(segment));
+        }
+        _size.store(0, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t max_segments = 64;
+
+    size_t segment_of(size_t index) const noexcept {
+        return static_cast<size_t>(std::bit_width(index >> _first_shift));
+    }
+
+    size_t segment_start(size_t segment) const noexcept {
+        return segment == 0 ? 0 : size_t(1) << (_first_shift + segment - 1);
+    }
+
+    size_t segment_capacity(size_t segment) const noexcept {
+        return segment == 0 ? size_t(1) << _first_shift : segment_start(segment);
+    }
+
+    T* slot(size_t idx) const {
+        if (idx >= size()) throw std::out_of_range("ConcurrentArray index out of range");
+        const size_t segment = segment_of(idx);
+        return _segments[segment].load(std::memory_order_acquire) + (idx - segment_start(segment));
+    }
+
+    // Слот уже захвачен, поэтому нехватка памяти под сегмент оставила бы
+    // в массиве пропуск: она завершает программу (noexcept)
+    T* acquire_segment(size_t segment) noexcept {
+        T* data = _segments[segment].load(std::memory_order_acquire);
+        if (data) return data;
+        T* fresh = std::allocator<T>().allocate(segment_capacity(segment));
+        if (_segments[segment].compare_exchange_strong(data, fresh, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            return fresh;
+        }
+        deallocate(fresh, segment_capacity(segment));
+        return data;
+    }
+
+    static void deallocate(T* data, size_t count) noexcept {
+        if (data) std::allocator<T>().deallocate(data, count);
+    }
+
+    const size_t _first_shift;
+    // Счётчик — единственное место, куда пишут все потоки: отдельная строка кэша
+    alignas(64) std::atomic<size_t> _size{0};
+    alignas(64) std::atomic<T*> _segments[max_segments] = {};
+};
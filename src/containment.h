@@ -0,0 +1,170 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "point.h"
+#include "simd_kernels.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FIGURES_CONTAINMENT_INLINE inline __attribute__((always_inline))
+#else
+#define FIGURES_CONTAINMENT_INLINE inline
+#endif
+
+// Пакетная проверка принадлежности точек фигуре. Граница считается
+// частью фигуры. Точки обрабатываются блоками: координаты блока
+// раскладываются в отдельные массивы, а проверка каждого ребра идёт
+// по блоку без ветвлений — такие циклы компилятор векторизует
+// (несколько точек в одном SIMD-регистре). Вариант для AVX2 / AVX-512
+// выбирается при запуске, как в simd_kernels.h.
+
+namespace containment {
+
+inline constexpr size_t block_size = 64;
+
+// Четыре вершины обходят углы прямоугольника ненулевой площади со
+// сторонами вдоль осей: горизонтальные и вертикальные рёбра чередуются,
+// ни одно не вырождено в точку. Только тогда многоугольник совпадает со
+// своим габаритом; вырожденные и самоперекрывающиеся четырёхугольники
+// проверяются общим методом
+template<class T>
+bool axis_aligned_box(std::span<const Point<T>> vertices) {
+    if (vertices.size() != 4) return false;
+    auto horizontal = [](const Point<T>& p, const Point<T>& q) {
+        return p.getY() == q.getY() && p.getX() != q.getX();
+    };
+    auto vertical = [](const Point<T>& p, const Point<T>& q) {
+        return p.getX() == q.getX() && p.getY() != q.getY();
+    };
+    const bool first_horizontal = horizontal(vertices[0], vertices[1]);
+    for (size_t i = 0; i < 4; ++i) {
+        const Point<T>& p = vertices[i];
+        const Point<T>& q = vertices[(i + 1) % 4];
+        const bool edge_ok = (i % 2 == 0) == first_horizontal ? horizontal(p, q) : vertical(p, q);
+        if (!edge_ok) return false;
+    }
+    return true;
+}
+
+// Проверка по прямоугольнику [min, max] со сторонами, параллельными осям
+template<class T>
+void box_contains(const Point<T>& min, const Point<T>& max, std::span<const Point<T>> points, bool* out) {
+    const T min_x = min.getX(), min_y = min.getY();
+    const T max_x = max.getX(), max_y = max.getY();
+    for (size_t k = 0; k < points.size(); ++k) {
+        const T x = points[k].getX();
+        const T y = points[k].getY();
+        out[k] = (x >= min_x) & (x <= max_x) & (y >= min_y) & (y <= max_y);
+    }
+}
+
+// Метод чётности пересечений (crossing number) с отсечением по габариту.
+// Точки на рёбрах определяются отдельно по векторному произведению
+// (для целых координат — точно). Флаги хранятся в 64-битных целых,
+// той же ширины, что и double: с однобайтовыми цикл не векторизуется.
+template<class T>
+FIGURES_CONTAINMENT_INLINE void polygon_contains_blocks(std::span<const Point<T>> vertices,
+                                                        std::span<const Point<T>> points, bool* out) {
+    const size_t n = vertices.size();
+    if (n == 0) {
+        std::fill(out, out + points.size(), false);
+        return;
+    }
+
+    double min_x = static_cast<double>(vertices[0].getX()), max_x = min_x;
+    double min_y = static_cast<double>(vertices[0].getY()), max_y = min_y;
+    for (const Point<T>& v : vertices) {
+        min_x = std::min(min_x, static_cast<double>(v.getX()));
+        max_x = std::max(max_x, static_cast<double>(v.getX()));
+        min_y = std::min(min_y, static_cast<double>(v.getY()));
+        max_y = std::max(max_y, static_cast<double>(v.getY()));
+    }
+
+    double px[block_size], py[block_size];
+    std::int64_t in_box[block_size], parity[block_size], on_edge[block_size];
+
+    for (size_t begin = 0; begin < points.size(); begin += block_size) {
+        const size_t m = std::min(block_size, points.size() - begin);
+        std::int64_t any = 0;
+        for (size_t k = 0; k < m; ++k) {
+            px[k] = static_cast<double>(points[begin + k].getX());
+            py[k] = static_cast<double>(points[begin + k].getY());
+        }
+        for (size_t k = 0; k < m; ++k) {
+            in_box[k] = std::int64_t(px[k] >= min_x) & std::int64_t(px[k] <= max_x)
+                      & std::int64_t(py[k] >= min_y) & std::int64_t(py[k] <= max_y);
+            parity[k] = 0;
+            on_edge[k] = 0;
+            any |= in_box[k];
+        }
+        // Весь блок вне габарита — рёбра не проверяются
+        if (!any) {
+            std::fill(out + begin, out + begin + m, false);
+            continue;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const double xi = static_cast<double>(vertices[i].getX());
+            const double yi = static_cast<double>(vertices[i].getY());
+            const double xj = static_cast<double>(vertices[(i + 1) % n].getX());
+            const double yj = static_cast<double>(vertices[(i + 1) % n].getY());
+            const double dx = xj - xi, dy = yj - yi;
+            // Для горизонтального ребра наклон не нужен: оно не пересекает луч
+            const double slope = dy != 0.0 ? dx / dy : 0.0;
+            const double edge_min_x = std::min(xi, xj), edge_max_x = std::max(xi, xj);
+            const double edge_min_y = std::min(yi, yj), edge_max_y = std::max(yi, yj);
+
+            // Два отдельных цикла: общий цикл GCC не векторизует под AVX2
+            for (size_t k = 0; k < m; ++k) {
+                const double x = px[k], y = py[k];
+                const std::int64_t straddles = std::int64_t(yi > y) ^ std::int64_t(yj > y);
+                parity[k] ^= straddles & std::int64_t(x < xi + (y - yi) * slope);
+            }
+            for (size_t k = 0; k < m; ++k) {
+                const double x = px[k], y = py[k];
+                const double cross = dx * (y - yi) - dy * (x - xi);
+                on_edge[k] |= std::int64_t(cross == 0.0)
+                            & std::int64_t(x >= edge_min_x) & std::int64_t(x <= edge_max_x)
+                            & std::int64_t(y >= edge_min_y) & std::int64_t(y <= edge_max_y);
+            }
+        }
+
+        for (size_t k = 0; k < m; ++k) {
+            out[begin + k] = (in_box[k] & (parity[k] | on_edge[k])) != 0;
+        }
+    }
+}
+
+#ifdef FIGURES_SIMD_X86
+// Тот же код, векторизованный компилятором под AVX2 / AVX-512
+// (без FMA, поэтому проверка cross == 0 даёт тот же результат)
+template<class T>
+FIGURES_SIMD_TARGET("avx2")
+void polygon_contains_avx2(std::span<const Point<T>> vertices, std::span<const Point<T>> points, bool* out) {
+    polygon_contains_blocks(vertices, points, out);
+}
+
+template<class T>
+FIGURES_SIMD_TARGET("avx512f")
+void polygon_contains_avx512(std::span<const Point<T>> vertices, std::span<const Point<T>> points, bool* out) {
+    polygon_contains_blocks(vertices, points, out);
+}
+#endif
+
+template<class T>
+void polygon_contains(std::span<const Point<T>> vertices, std::span<const Point<T>> points, bool* out,
+                      simd::Level level = simd::active_level()) {
+#ifdef FIGURES_SIMD_X86
+    switch (simd::clamp_level(level)) {
+        case simd::Level::AVX512: return polygon_contains_avx512(vertices, points, out);
+        case simd::Level::AVX2: return polygon_contains_avx2(vertices, points, out);
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    polygon_contains_blocks(vertices, points, out);
+}
+
+} // namespace containment
@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include "array.h"
+#include "point.h"
+#include "thread_pool.h"
+
+// Выпуклая оболочка множества точек (монотонная цепочка Эндрю): точки
+// сортируются по x, затем по y, нижняя и верхняя цепочки строятся за один
+// проход каждая — O(n log n). Вершины возвращаются против часовой стрелки,
+// начиная с наименьшей (x, y); точки на рёбрах и повторы отбрасываются.
+// Повороты считаются в double, как и площади фигур: для целых координат
+// результат точен, пока |x| и |y| меньше 2^25.
+//
+// Перегрузка с ThreadPool делит точки на блоки по grain, строит оболочки
+// блоков параллельно и затем оболочку объединения их вершин. Оболочка
+// объединения совпадает с оболочкой всех точек, поэтому результат тот же,
+// что у последовательной версии, при любом числе потоков.
+
+inline constexpr size_t convex_hull_grain = size_t(1) << 16;
+
+namespace hull_detail {
+
+// > 0 — поворот o -> a -> b против часовой стрелки
+template<class T>
+double cross(const Point<T>& o, const Point<T>& a, const Point<T>& b) {
+    const double ax = static_cast<double>(a.getX()) - static_cast<double>(o.getX());
+    const double ay = static_cast<double>(a.getY()) - static_cast<double>(o.getY());
+    const double bx = static_cast<double>(b.getX()) - static_cast<double>(o.getX());
+    const double by = static_cast<double>(b.getY()) - static_cast<double>(o.getY());
+    return ax * by - ay * bx;
+}
+
+// Сортирует точки и убирает повторы
+template<class T>
+void sort_unique(Array<Point<T>>& points) {
+    std::sort(points.begin(), points.end(), [](const Point<T>& a, const Point<T>& b) {
+        return a.getX() < b.getX() || (a.getX() == b.getX() && a.getY() < b.getY());
+    });
+    auto last = std::unique(points.begin(), points.end(), [](const Point<T>& a, const Point<T>& b) {
+        return a.getX() == b.getX() && a.getY() == b.getY();
+    });
+    points.erase(last, points.end());
+}
+
+// Точки отсортированы и без повторов
+template<class T>
+Array<Point<T>> monotone_chain(const Array<Point<T>>& sorted) {
+    const size_t n = sorted.size();
+    if (n < 3) return sorted;
+
+    Array<Point<T>> hull;
+    hull.reserve(n + 1);
+    auto turns_left = [&hull](const Point<T>& point) {
+        const size_t size = hull.size();
+        return cross(hull.unchecked(size - 2), hull.unchecked(size - 1), point) > 0;
+    };
+    for (const Point<T>& point : sorted) {
+        while (hull.size() >= 2 && !turns_left(point)) hull.pop_back();
+        hull.push_back(point);
+    }
+    // Верхняя цепочка не снимает вершины нижней
+    const size_t lower = hull.size() + 1;
+    for (size_t i = n - 1; i-- > 0;) {
+        const Point<T>& point = sorted.unchecked(i);
+        while (hull.size() >= lower && !turns_left(point)) hull.pop_back();
+        hull.push_back(point);
+    }
+    // Последняя вершина верхней цепочки — снова первая точка
+    hull.pop_back();
+    return hull;
+}
+
+} // namespace hull_detail
+
+template<class T>
+Array<Point<T>> convex_hull(std::span<const Point<T>> points) {
+    Array<Point<T>> sorted;
+    sorted.reserve(points.size());
+    for (const Point<T>& point : points) {
+        sorted.push_back(point);
+    }
+    hull_detail::sort_unique(sorted);
+    return hull_detail::monotone_chain(sorted);
+}
+
+template<class T>
+Array<Point<T>> convex_hull(ThreadPool& pool, std::span<const Point<T>> points,
+                            size_t grain = convex_hull_grain) {
+    grain = std::max<size_t>(grain, 3);
+    const size_t blocks = (points.size() + grain - 1) / grain;
+    if (blocks <= 1) return convex_hull(points);
+
+    Array<Array<Point<T>>> partials;
+    partials.resize(blocks);
+    pool.parallel_for(points.size(), grain, [&](size_t begin, size_t end) {
+        partials.unchecked(begin / grain) = convex_hull(points.subspan(begin, end - begin));
+    });
+
+    size_t total = 0;
+    for (const auto& partial : partials) total += partial.size();
+    Array<Point<T>> vertices;
+    vertices.reserve(total);
+    for (const auto& partial : partials) {
+        for (const Point<T>& point : partial) {
+            vertices.push_back(point);
+        }
+    }
+    hull_detail::sort_unique(vertices);
+    return hull_detail::monotone_chain(vertices);
+}
@@ -1,35 +1,175 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "affine_transform.h"
+#include "array.h"
+#include "containment.h"
+#include "instrumentation.h"
 #include "point.h"
 
+// Вид фигуры: позволяет обрабатывать коллекции без dynamic_cast
+enum class FigureKind : std::uint8_t {
+    Square,
+    Rectangle,
+    Trapezoid,
+    // Произвольный многоугольник (PolygonFigure)
+    Polygon
+};
+
+// Ограничивающий прямоугольник со сторонами, параллельными осям
+template<class T>
+struct BoundingBox {
+    Point<T> min;
+    Point<T> max;
+};
+
+// Среднее координат вершин: sum / count. Целая сумма делится со знаком
+// и округлением вниз — как у четырёхугольников, где SIMD-ядра сдвигают
+// сумму вправо
+template<class T>
+constexpr T vertex_mean(T sum, size_t count) {
+    if constexpr (std::is_integral_v<T>) {
+        const T n = static_cast<T>(count);
+        T quotient = sum / n;
+        if (sum % n != 0 && (sum < 0) != (n < 0)) --quotient;
+        return quotient;
+    } else {
+        return sum / static_cast<T>(count);
+    }
+}
+
+// Лениво вычисляемое значение для const-методов. Если несколько потоков
+// промахнулись одновременно, сохраняет значение только один из них,
+// остальные возвращают своё — гонки по данным нет.
+template<class V>
+class CachedValue {
+public:
+    CachedValue() noexcept = default;
+    // Копия начинает с пустого кэша
+    CachedValue(const CachedValue&) noexcept {}
+    CachedValue& operator=(const CachedValue&) noexcept {
+        invalidate();
+        return *this;
+    }
+
+    template<class Compute>
+    V get(Compute&& compute) const {
+        if (_state.load(std::memory_order_acquire) == ready) return _value;
+        V value = compute();
+        std::uint8_t expected = empty;
+        if (_state.compare_exchange_strong(expected, busy, std::memory_order_acquire)) {
+            _value = value;
+            _state.store(ready, std::memory_order_release);
+        }
+        return value;
+    }
+
+    bool valid() const noexcept { return _state.load(std::memory_order_acquire) == ready; }
+    void invalidate() noexcept { _state.store(empty, std::memory_order_release); }
+
+    // Заменяет готовое значение на func(value), пустой кэш не трогает.
+    // Как и любое изменение фигуры, не вызывается одновременно с чтением
+    template<class Func>
+    void update(Func&& func) {
+        if (valid()) _value = func(_value);
+    }
+
+private:
+    enum : std::uint8_t { empty, busy, ready };
+
+    mutable std::atomic<std::uint8_t> _state{empty};
+    mutable V _value{};
+};
+
 template<class T>
 class Figure {
 public:
     using P = Point<T>;
 
     Figure() = default;
-    virtual ~Figure() noexcept = default;
 
-    Figure(const Figure<T>& other) {
-        for (size_t i = 0; i < other.get_points_count(); ++i) {
-            points.push_back(std::make_unique<P>(other.get_point(i)));
+    // Точки сверх встроенного буфера размещаются в resource
+    explicit Figure(std::span<const P> points,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : points(resource) {
+        this->points.reserve(points.size());
+        for (const P& point : points) {
+            this->points.push_back(point);
         }
     }
+    virtual ~Figure() noexcept = default;
+
+    // Копия разделяет с оригиналом буфер точек (копирование при записи);
+    // новые точки копии размещаются в ресурсе по умолчанию, поэтому точки
+    // фигур из арены копируются — копия не зависит от времени жизни арены
+    Figure(const Figure<T>& other) : points(other.points, std::pmr::get_default_resource()) {
+        FIGURES_COUNT(Figure, copies, 1);
+    }
 
     Figure<T>& operator=(const Figure<T>& other) {
         if (this == &other) return *this;
-        PointContainer<Point<T>> tmp;
-        for (size_t i = 0; i < other.get_points_count(); ++i) {
-            tmp.push_back(std::make_unique<P>(other.get_point(i)));
-        }
-        this->points = std::move(tmp);
+        FIGURES_COUNT(Figure, copies, 1);
+        points = other.points;
+        touch();
         return *this;
     }
 
-    Figure(Figure<T>&& other) noexcept = default;
+    // Источник остаётся без точек: его кэши сбрасываются, версия растёт
+    Figure(Figure<T>&& other) noexcept : points(std::move(other.points)), _version(other._version) {
+        FIGURES_COUNT(Figure, moves, 1);
+        other.touch();
+    }
 
     void add_point(const P& point) {
-        points.push_back(std::make_unique<P>(point));
+        points.push_back(point);
+        touch();
+    }
+
+    // Преобразует вершины на месте пакетным ядром из affine_transform.h.
+    // Кэши пересчитываются без обхода вершин, если результат от этого не
+    // меняется: площадь умножается на |det|, если формула площади фигуры
+    // остаётся верной (area_scales_with), а для целых координат — ещё и
+    // при целых коэффициентах, иначе мешает округление; центр
+    // преобразуется для дробных координат, габарит — при сохранении осей.
+    // Остальные кэши сбрасываются. Версия растёт, как при любом изменении
+    void transform(const AffineTransform& m) {
+        points.modify([&m](P* data, size_t size) { affine::transform_points(m, data, size); });
+        ++_version;
+        bool area_scaled = false;
+        if (area_scales_with(m) && (std::is_floating_point_v<T> || m.has_integer_coefficients())) {
+            const double scale = std::abs(m.determinant());
+            _area.update([scale, &area_scaled](double area) {
+                area_scaled = std::isfinite(area * scale);
+                return area * scale;
+            });
+        }
+        // inf и NaN в кэше не вернулись бы к конечной площади после
+        // обратного преобразования, поэтому такая площадь пересчитывается
+        if (!area_scaled) _area.invalidate();
+        if constexpr (std::is_floating_point_v<T>) {
+            _center.update([&m](const P& center) { return m.apply(center); });
+        } else {
+            // Среднее вершин делится нацело: сдвиг центра не равен пересчёту
+            _center.invalidate();
+        }
+        if (m.preserves_axes()) {
+            // Округление монотонно: крайние вершины остаются крайними,
+            // при отрицательном масштабе min и max меняются местами
+            _bounding_box.update([&m](const BoundingBox<T>& box) {
+                const P first = m.apply(box.min), second = m.apply(box.max);
+                return BoundingBox<T>{P(std::min(first.getX(), second.getX()), std::min(first.getY(), second.getY())),
+                                      P(std::max(first.getX(), second.getX()), std::max(first.getY(), second.getY()))};
+            });
+        } else {
+            _bounding_box.invalidate();
+        }
     }
 
     size_t get_points_count() const {
@@ -40,8 +180,46 @@ public:
         return points[index];
     }
 
-    virtual P center() const = 0;
-    virtual operator double() = 0;
+    virtual FigureKind kind() const = 0;
+
+    // Площадь, центр и габариты вычисляются при первом обращении
+    // и сбрасываются любым изменением фигуры
+    double area() const {
+        return _area.get([this] { return compute_area(); });
+    }
+
+    operator double() const { return area(); }
+
+    P center() const {
+        return _center.get([this] { return compute_center(); });
+    }
+
+    BoundingBox<T> bounding_box() const {
+        return _bounding_box.get([this] { return compute_bounding_box(); });
+    }
+
+    // Растёт при каждом изменении: по нему коллекции узнают, какие фигуры
+    // нужно пересчитать
+    std::uint64_t version() const noexcept { return _version; }
+
+    // Принадлежность точек фигуре (граница включается): out[k] для points[k]
+    void contains(std::span<const P> query, std::span<bool> out) const {
+        if (out.size() != query.size()) throw std::invalid_argument("Output size does not match points");
+        contains_batch(query, out.data());
+    }
+
+    Array<bool> contains(std::span<const P> query) const {
+        Array<bool> result;
+        result.resize(query.size());
+        contains_batch(query, result.data());
+        return result;
+    }
+
+    bool contains(const P& point) const {
+        bool result = false;
+        contains_batch(std::span<const P>(&point, 1), &result);
+        return result;
+    }
 
     friend std::ostream& operator<<(std::ostream& os, const Figure<T>& figure) {
         os << "Figure with " << figure.points.size() << " points:\n";
@@ -53,5 +231,44 @@ public:
 }
 
 protected:
+    virtual double compute_area() const = 0;
+    virtual P compute_center() const = 0;
+
+    // Равна ли compute_area() после преобразования m прежней площади,
+    // умноженной на |det|. По умолчанию — нет: кэш площади сбрасывается
+    virtual bool area_scales_with(const AffineTransform& m) const {
+        (void)m;
+        return false;
+    }
+
+    // По умолчанию — метод чётности пересечений по всем рёбрам
+    virtual void contains_batch(std::span<const P> query, bool* out) const {
+        containment::polygon_contains(std::span<const P>(points.data(), points.size()), query, out);
+    }
+
+    BoundingBox<T> compute_bounding_box() const {
+        if (points.empty()) return {};
+        BoundingBox<T> box{points[0], points[0]};
+        for (const P& point : points) {
+            box.min = P(std::min(box.min.getX(), point.getX()), std::min(box.min.getY(), point.getY()));
+            box.max = P(std::max(box.max.getX(), point.getX()), std::max(box.max.getY(), point.getY()));
+        }
+        return box;
+    }
+
+    // Вызывается после любого изменения points
+    void touch() noexcept {
+        ++_version;
+        _area.invalidate();
+        _center.invalidate();
+        _bounding_box.invalidate();
+    }
+
     PointContainer<P> points;
+
+private:
+    CachedValue<double> _area;
+    CachedValue<P> _center;
+    CachedValue<BoundingBox<T>> _bounding_box;
+    std::uint64_t _version = 0;
 };
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+#include <execution>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include "array.h"
+#include "figure.h"
+#include "thread_pool.h"
+
+// Операции над всей коллекцией фигур. Перегрузки без политики
+// используют std::execution::par, перегрузки с ThreadPool
+// суммируют детерминированно (см. parallel_reduce). Политики unseq
+// и par_unseq не подходят: area() и center() читают кэш фигуры через
+// атомарные операции с синхронизацией, которые нельзя векторизовать.
+
+template<class ExecutionPolicy>
+concept ExecutionPolicyType = std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>;
+
+template<class T, ExecutionPolicyType ExecutionPolicy>
+double total_area(ExecutionPolicy&& policy, const Array<std::shared_ptr<Figure<T>>>& figures) {
+    return std::transform_reduce(std::forward<ExecutionPolicy>(policy),
+        figures.begin(), figures.end(), 0.0, std::plus<>(),
+        [](const std::shared_ptr<Figure<T>>& figure) { return static_cast<double>(*figure); });
+}
+
+template<class T>
+double total_area(const Array<std::shared_ptr<Figure<T>>>& figures) {
+    return total_area(std::execution::par, figures);
+}
+
+template<class T, ExecutionPolicyType ExecutionPolicy>
+Array<double> areas(ExecutionPolicy&& policy, const Array<std::shared_ptr<Figure<T>>>& figures) {
+    Array<double> result;
+    result.resize(figures.size());
+    std::transform(std::forward<ExecutionPolicy>(policy),
+        figures.begin(), figures.end(), result.begin(),
+        [](const std::shared_ptr<Figure<T>>& figure) { return static_cast<double>(*figure); });
+    return result;
+}
+
+template<class T>
+Array<double> areas(const Array<std::shared_ptr<Figure<T>>>& figures) {
+    return areas(std::execution::par, figures);
+}
+
+template<class T, ExecutionPolicyType ExecutionPolicy>
+Array<Point<T>> centers(ExecutionPolicy&& policy, const Array<std::shared_ptr<Figure<T>>>& figures) {
+    Array<Point<T>> result;
+    result.resize(figures.size());
+    std::transform(std::forward<ExecutionPolicy>(policy),
+        figures.begin(), figures.end(), result.begin(),
+        [](const std::shared_ptr<Figure<T>>& figure) { return figure->center(); });
+    return result;
+}
+
+template<class T>
+Array<Point<T>> centers(const Array<std::shared_ptr<Figure<T>>>& figures) {
+    return centers(std::execution::par, figures);
+}
+
+template<class T>
+double total_area(ThreadPool& pool, const Array<std::shared_ptr<Figure<T>>>& figures,
+                  size_t grain = ThreadPool::default_grain) {
+    return parallel_reduce(pool, figures, 0.0,
+        [](const std::shared_ptr<Figure<T>>& figure) { return static_cast<double>(*figure); },
+        std::plus<>(), grain);
+}
+
+template<class T>
+Array<double> areas(ThreadPool& pool, const Array<std::shared_ptr<Figure<T>>>& figures,
+                    size_t grain = ThreadPool::default_grain) {
+    Array<double> result;
+    result.resize(figures.size());
+    pool.parallel_for(figures.size(), grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result.unchecked(i) = static_cast<double>(*figures.unchecked(i));
+        }
+    });
+    return result;
+}
+
+template<class T>
+Array<Point<T>> centers(ThreadPool& pool, const Array<std::shared_ptr<Figure<T>>>& figures,
+                        size_t grain = ThreadPool::default_grain) {
+    Array<Point<T>> result;
+    result.resize(figures.size());
+    pool.parallel_for(figures.size(), grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result.unchecked(i) = figures.unchecked(i)->center();
+        }
+    });
+    return result;
+}
+
+// Преобразует все фигуры на месте (Figure::transform). Фигура, входящая
+// в коллекцию несколько раз, преобразуется несколько раз
+template<class T>
+void transform_figures(Array<std::shared_ptr<Figure<T>>>& figures, const AffineTransform& m) {
+    for (const auto& figure : figures) {
+        figure->transform(m);
+    }
+}
+
+// Каждая фигура должна входить в коллекцию один раз: иначе её
+// преобразуют два потока сразу
+template<class T>
+void transform_figures(ThreadPool& pool, Array<std::shared_ptr<Figure<T>>>& figures, const AffineTransform& m,
+                       size_t grain = ThreadPool::default_grain) {
+    pool.parallel_for(figures.size(), grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            figures.unchecked(i)->transform(m);
+        }
+    });
+}
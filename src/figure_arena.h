@@ -0,0 +1,55 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+
+// Монотонная арена для пакетных задач «загрузить — обработать — выбросить».
+// Память берётся у upstream крупными блоками, deallocate ничего не делает,
+// всё освобождается разом в release() или в деструкторе. Фигуры и массивы,
+// созданные в арене, должны быть уничтожены до неё.
+class FigureArena : public std::pmr::monotonic_buffer_resource {
+public:
+    static constexpr size_t default_block_size = size_t(1) << 20;
+
+    explicit FigureArena(size_t initial_block_size = default_block_size,
+                         std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : std::pmr::monotonic_buffer_resource(initial_block_size, upstream) {}
+};
+
+// Ресурс-обёртка, считающий выделения: число вызовов, текущий и пиковый
+// объём. Нужен для замеров и тестов, сам память не хранит.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : _upstream(upstream) {}
+
+    size_t allocations() const noexcept { return _allocations; }
+    size_t deallocations() const noexcept { return _deallocations; }
+    size_t bytes_in_use() const noexcept { return _bytes_in_use; }
+    size_t peak_bytes() const noexcept { return _peak_bytes; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* ptr = _upstream->allocate(bytes, alignment);
+        ++_allocations;
+        _bytes_in_use += bytes;
+        _peak_bytes = std::max(_peak_bytes, _bytes_in_use);
+        return ptr;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        _upstream->deallocate(ptr, bytes, alignment);
+        ++_deallocations;
+        _bytes_in_use -= bytes;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* _upstream;
+    size_t _allocations = 0;
+    size_t _deallocations = 0;
+    size_t _bytes_in_use = 0;
+    size_t _peak_bytes = 0;
+};
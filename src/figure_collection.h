@@ -0,0 +1,256 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array.h"
+#include "compensated_sum.h"
+#include "figure.h"
+
+namespace collection_detail {
+
+// Значения с числом повторов: наименьшее и наибольшее за O(1),
+// добавление и удаление за O(log k), где k — число различных значений.
+// NaN нарушает порядок ключей std::map, поэтому сюда не попадает
+template<class V>
+class CountedValues {
+public:
+    void insert(V value) { ++_counts[value]; }
+
+    void erase(V value) {
+        auto it = _counts.find(value);
+        if (it == _counts.end()) return;
+        if (--it->second == 0) _counts.erase(it);
+    }
+
+    V min() const { return _counts.begin()->first; }
+    V max() const { return _counts.rbegin()->first; }
+
+private:
+    std::map<V, size_t> _counts;
+};
+
+} // namespace collection_detail
+
+// Коллекция фигур со сводными величинами, которые обновляются при каждом
+// добавлении и удалении: суммарная площадь, среднее центров, общий габарит,
+// число и площадь фигур каждого вида. Чтение сводных величин никогда не
+// обходит коллекцию. Суммы и счётчики обновляются за O(1), габарит — за
+// O(log k), где k — число различных координат на его сторонах.
+//
+// Суммы ведутся с компенсацией Ноймайера, поэтому длинные серии добавлений
+// и удалений не накапливают ошибку округления. Вклад фигуры запоминается
+// при добавлении: если фигура изменилась после этого, коллекции нужно
+// сообщить об этом через update() или modify().
+template<class T>
+class FigureCollection {
+public:
+    using P = Point<T>;
+    using Box = BoundingBox<T>;
+    using FigurePtr = std::shared_ptr<Figure<T>>;
+
+    static constexpr size_t kind_count = static_cast<size_t>(FigureKind::Polygon) + 1;
+
+    FigureCollection() = default;
+
+    explicit FigureCollection(const Array<FigurePtr>& figures) {
+        _figures.reserve(figures.size());
+        _contributions.reserve(figures.size());
+        for (const auto& figure : figures) {
+            push_back(figure);
+        }
+    }
+
+    void push_back(FigurePtr figure) {
+        if (!figure) throw std::invalid_argument("Null figure");
+        Contribution contribution = measure(*figure);
+        _figures.push_back(std::move(figure));
+        _contributions.push_back(contribution);
+        add(contribution);
+    }
+
+    // Сохраняет порядок фигур (сдвиг указателей — memmove)
+    void erase(size_t index) {
+        const bool subtracted = subtract(_contributions[index]);
+        _figures.erase(_figures.begin() + index);
+        _contributions.erase(_contributions.begin() + index);
+        if (!subtracted) rebuild();
+        reset_if_empty();
+    }
+
+    // За O(1): на место удалённой встаёт последняя фигура
+    void erase_unordered(size_t index) {
+        const bool subtracted = subtract(_contributions[index]);
+        const size_t last = _figures.size() - 1;
+        if (index != last) {
+            _figures.unchecked(index) = std::move(_figures.unchecked(last));
+            _contributions.unchecked(index) = _contributions.unchecked(last);
+        }
+        _figures.pop_back();
+        _contributions.pop_back();
+        if (!subtracted) rebuild();
+        reset_if_empty();
+    }
+
+    // Пересчитывает вклад фигуры, изменённой в обход коллекции
+    void update(size_t index) {
+        Contribution& contribution = _contributions[index];
+        const bool subtracted = subtract(contribution);
+        contribution = measure(*_figures.unchecked(index));
+        if (subtracted) {
+            add(contribution);
+        } else {
+            rebuild();
+        }
+    }
+
+    // Изменяет фигуру через func(Figure<T>&) и обновляет её вклад. Вклад
+    // обновляется и при исключении из func: фигура могла успеть измениться
+    template<class Func>
+    void modify(size_t index, Func&& func) {
+        Figure<T>& figure = *_figures[index];
+        try {
+            std::forward<Func>(func)(figure);
+        } catch (...) {
+            update(index);
+            throw;
+        }
+        update(index);
+    }
+
+    // Преобразует все фигуры на месте (Figure::transform) и пересобирает
+    // сводные величины. Изменяются и фигуры, на которые ссылаются снаружи
+    void transform(const AffineTransform& m) {
+        for (size_t i = 0; i < _figures.size(); ++i) {
+            _figures.unchecked(i)->transform(m);
+            _contributions.unchecked(i) = measure(*_figures.unchecked(i));
+        }
+        rebuild();
+    }
+
+    void clear() noexcept {
+        _figures.clear();
+        _contributions.clear();
+        _aggregates = Aggregates();
+    }
+
+    size_t size() const noexcept { return _figures.size(); }
+    bool empty() const noexcept { return _figures.empty(); }
+
+    const FigurePtr& operator[](size_t index) const { return _figures[index]; }
+    const Array<FigurePtr>& figures() const noexcept { return _figures; }
+
+    double total_area() const noexcept { return _aggregates.area.value(); }
+
+    // Среднее центров фигур; для пустой коллекции — (0, 0)
+    Point<double> centroid() const noexcept {
+        if (empty()) return {};
+        const double n = static_cast<double>(size());
+        return Point<double>(_aggregates.center_x.value() / n, _aggregates.center_y.value() / n);
+    }
+
+    // Габарит всех вершин; пустой, если вершин нет (как у Figure::bounding_box)
+    Box bounding_box() const {
+        if (_aggregates.boxes == 0) return {};
+        return {P(_aggregates.min_x.min(), _aggregates.min_y.min()),
+                P(_aggregates.max_x.max(), _aggregates.max_y.max())};
+    }
+
+    size_t count(FigureKind kind) const noexcept { return _aggregates.kind_counts[index_of(kind)]; }
+    double area(FigureKind kind) const noexcept { return _aggregates.kind_areas[index_of(kind)].value(); }
+
+private:
+    // Что фигура внесла в сводные величины при последнем замере
+    struct Contribution {
+        double area;
+        double center_x;
+        double center_y;
+        Box box;
+        FigureKind kind;
+        bool has_box;
+    };
+
+    struct Aggregates {
+        CompensatedSum area;
+        CompensatedSum center_x;
+        CompensatedSum center_y;
+        collection_detail::CountedValues<T> min_x, min_y, max_x, max_y;
+        size_t boxes = 0;
+        size_t kind_counts[kind_count] = {};
+        CompensatedSum kind_areas[kind_count];
+    };
+
+    static size_t index_of(FigureKind kind) noexcept { return static_cast<size_t>(kind); }
+
+    // Габарит с NaN в координатах в общий габарит не входит
+    static bool orderable(const Box& box) noexcept {
+        if constexpr (std::is_floating_point_v<T>) {
+            return !std::isnan(box.min.getX()) && !std::isnan(box.min.getY())
+                && !std::isnan(box.max.getX()) && !std::isnan(box.max.getY());
+        } else {
+            (void)box;
+            return true;
+        }
+    }
+
+    static Contribution measure(const Figure<T>& figure) {
+        const P center = figure.center();
+        const Box box = figure.bounding_box();
+        return {figure.area(), static_cast<double>(center.getX()), static_cast<double>(center.getY()),
+                box, figure.kind(), figure.get_points_count() > 0 && orderable(box)};
+    }
+
+    void add(const Contribution& c) {
+        _aggregates.area.add(c.area);
+        _aggregates.center_x.add(c.center_x);
+        _aggregates.center_y.add(c.center_y);
+        ++_aggregates.kind_counts[index_of(c.kind)];
+        _aggregates.kind_areas[index_of(c.kind)].add(c.area);
+        if (c.has_box) {
+            _aggregates.min_x.insert(c.box.min.getX());
+            _aggregates.min_y.insert(c.box.min.getY());
+            _aggregates.max_x.insert(c.box.max.getX());
+            _aggregates.max_y.insert(c.box.max.getY());
+            ++_aggregates.boxes;
+        }
+    }
+
+    // inf и NaN из суммы не вычесть (inf - inf = NaN): такой вклад не
+    // трогается, вызывающий пересобирает сводные величины через rebuild()
+    bool subtract(const Contribution& c) {
+        if (!std::isfinite(c.area) || !std::isfinite(c.center_x) || !std::isfinite(c.center_y)) return false;
+        _aggregates.area.add(-c.area);
+        _aggregates.center_x.add(-c.center_x);
+        _aggregates.center_y.add(-c.center_y);
+        --_aggregates.kind_counts[index_of(c.kind)];
+        _aggregates.kind_areas[index_of(c.kind)].add(-c.area);
+        if (c.has_box) {
+            _aggregates.min_x.erase(c.box.min.getX());
+            _aggregates.min_y.erase(c.box.min.getY());
+            _aggregates.max_x.erase(c.box.max.getX());
+            _aggregates.max_y.erase(c.box.max.getY());
+            --_aggregates.boxes;
+        }
+        return true;
+    }
+
+    // Сводные величины заново по запомненным вкладам — O(n)
+    void rebuild() {
+        _aggregates = Aggregates();
+        for (const Contribution& c : _contributions) {
+            add(c);
+        }
+    }
+
+    // Пустая коллекция начинает суммы заново, без остатков компенсации
+    void reset_if_empty() noexcept {
+        if (empty()) _aggregates = Aggregates();
+    }
+
+    Array<FigurePtr> _figures;
+    Array<Contribution> _contributions;
+    Aggregates _aggregates;
+};
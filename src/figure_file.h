@@ -0,0 +1,192 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "array.h"
+#include "figure_store.h"
+#include "mapped_file.h"
+
+// Двоичный столбцовый формат фигур (версия 1, little-endian):
+//
+//     заголовок FigureFileHeader
+//     kinds    uint8  x figure_count
+//     offsets  uint64 x (figure_count + 1)
+//     xs       T      x vertex_count
+//     ys       T      x vertex_count
+//
+// Каждая секция выровнена на 64 байта, поэтому отображённый файл читается
+// без копирования: FigureFileView отдаёт указатели прямо в отображение.
+
+struct FigureFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint8_t coordinate_type;
+    std::uint8_t coordinate_size;
+    std::uint16_t flags;
+    std::uint64_t figure_count;
+    std::uint64_t vertex_count;
+    std::uint64_t kinds_offset;
+    std::uint64_t offsets_offset;
+    std::uint64_t xs_offset;
+    std::uint64_t ys_offset;
+    std::uint64_t file_size;
+};
+
+namespace figure_file {
+
+inline constexpr char magic[8] = {'F', 'I', 'G', 'C', 'O', 'L', 'S', '\0'};
+inline constexpr std::uint32_t version = 1;
+inline constexpr std::uint64_t alignment = 64;
+inline constexpr std::uint16_t flag_all_quads = 1;
+
+template<class T>
+concept Coordinate = std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template<Coordinate T>
+constexpr std::uint8_t coordinate_type() {
+    if constexpr (std::is_same_v<T, int>) return 1;
+    else if constexpr (std::is_same_v<T, float>) return 2;
+    else return 3;
+}
+
+constexpr std::uint64_t align_up(std::uint64_t offset) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+static_assert(std::endian::native == std::endian::little, "Figure files are little-endian");
+static_assert(sizeof(size_t) == sizeof(std::uint64_t), "Offsets are mapped as size_t");
+static_assert(sizeof(FigureKind) == 1);
+static_assert(std::is_trivially_copyable_v<FigureFileHeader>);
+
+} // namespace figure_file
+
+template<figure_file::Coordinate T>
+void write_figure_file(const std::string& path, const FigureStore<T>& store) {
+    using namespace figure_file;
+    FigureFileHeader header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.coordinate_type = coordinate_type<T>();
+    header.coordinate_size = sizeof(T);
+    header.flags = store.all_quads() ? flag_all_quads : 0;
+    header.figure_count = store.size();
+    header.vertex_count = store.vertex_count();
+    header.kinds_offset = align_up(sizeof(FigureFileHeader));
+    header.offsets_offset = align_up(header.kinds_offset + header.figure_count);
+    header.xs_offset = align_up(header.offsets_offset + (header.figure_count + 1) * sizeof(std::uint64_t));
+    header.ys_offset = align_up(header.xs_offset + header.vertex_count * sizeof(T));
+    header.file_size = header.ys_offset + header.vertex_count * sizeof(T);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot create file: " + path);
+    std::uint64_t written = 0;
+    auto write_section = [&](std::uint64_t offset, const void* data, std::uint64_t bytes) {
+        static const char zeros[alignment] = {};
+        out.write(zeros, static_cast<std::streamsize>(offset - written));
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        written = offset + bytes;
+    };
+    write_section(0, &header, sizeof(header));
+    write_section(header.kinds_offset, store.kinds().data(), store.kinds().size_bytes());
+    write_section(header.offsets_offset, store.offsets().data(), store.offsets().size_bytes());
+    write_section(header.xs_offset, store.xs().data(), store.xs().size_bytes());
+    write_section(header.ys_offset, store.ys().data(), store.ys().size_bytes());
+    if (!out.flush()) throw std::runtime_error("Cannot write file: " + path);
+}
+
+template<figure_file::Coordinate T>
+void write_figure_file(const std::string& path, const Array<std::shared_ptr<Figure<T>>>& figures) {
+    write_figure_file(path, FigureStore<T>::from_figures(figures));
+}
+
+// Отображённый файл только для чтения: площади и центры считаются прямо
+// по столбцам файла, объекты Figure не создаются. Конструктор проверяет
+// заголовок, границы секций и флаг четырёхугольников за O(1); смещения
+// каждой фигуры проверяются при обращении к ней (FigureColumns::vertex_range),
+// поэтому повреждённый файл не приводит к чтению за пределами отображения.
+// validate() проверяет все данные за O(n).
+template<figure_file::Coordinate T>
+class FigureFileView {
+public:
+    using P = Point<T>;
+
+    explicit FigureFileView(const std::string& path) : _file(path) {
+        using namespace figure_file;
+        if (_file.size() < sizeof(FigureFileHeader)) throw std::runtime_error("Figure file is too small: " + path);
+        FigureFileHeader header;
+        std::memcpy(&header, _file.data(), sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Not a figure file: " + path);
+        }
+        if (header.version != version) throw std::runtime_error("Unsupported figure file version: " + path);
+        if (header.coordinate_type != coordinate_type<T>() || header.coordinate_size != sizeof(T)) {
+            throw std::runtime_error("Figure file coordinate type mismatch: " + path);
+        }
+        const std::uint64_t n = header.figure_count;
+        const std::uint64_t v = header.vertex_count;
+        if (header.file_size != _file.size()
+            || !section_fits(header.kinds_offset, n, 1)
+            || !section_fits(header.offsets_offset, n + 1, sizeof(std::uint64_t))
+            || !section_fits(header.xs_offset, v, sizeof(T))
+            || !section_fits(header.ys_offset, v, sizeof(T))) {
+            throw std::runtime_error("Corrupted figure file layout: " + path);
+        }
+
+        const char* base = _file.data();
+        _columns.kinds = {reinterpret_cast<const FigureKind*>(base + header.kinds_offset), n};
+        _columns.offsets = {reinterpret_cast<const size_t*>(base + header.offsets_offset), n + 1};
+        _columns.xs = {reinterpret_cast<const T*>(base + header.xs_offset), v};
+        _columns.ys = {reinterpret_cast<const T*>(base + header.ys_offset), v};
+        _columns.all_quads = (header.flags & flag_all_quads) != 0;
+        if (_columns.offsets.front() != 0 || _columns.offsets.back() != v) {
+            throw std::runtime_error("Corrupted figure offsets: " + path);
+        }
+        // SIMD-ядра читают xs[4 * i + v] без смещений
+        if (_columns.all_quads && v != 4 * n) {
+            throw std::runtime_error("Corrupted figure file: quad flag does not match vertex count: " + path);
+        }
+    }
+
+    // Полная проверка: виды фигур допустимы, смещения не убывают,
+    // флаг четырёхугольников соответствует данным
+    bool validate() const {
+        for (size_t i = 0; i < size(); ++i) {
+            if (static_cast<std::uint8_t>(_columns.kinds[i]) > static_cast<std::uint8_t>(FigureKind::Polygon)) return false;
+            const size_t count = _columns.offsets[i + 1] - _columns.offsets[i];
+            if (_columns.offsets[i + 1] < _columns.offsets[i]) return false;
+            if (_columns.all_quads && count != 4) return false;
+        }
+        return true;
+    }
+
+    const FigureColumns<T>& columns() const noexcept { return _columns; }
+
+    size_t size() const noexcept { return _columns.size(); }
+    size_t vertex_count() const noexcept { return _columns.xs.size(); }
+    FigureKind kind(size_t index) const { return _columns.kinds[index]; }
+
+    double area(size_t index) const { return _columns.area(index); }
+    P center(size_t index) const { return _columns.center(index); }
+    Array<double> areas() const { return _columns.areas(); }
+    Array<P> centers() const { return _columns.centers(); }
+    double total_area() const { return _columns.total_area(); }
+
+    std::shared_ptr<Figure<T>> make_figure(size_t index) const { return _columns.make_figure(index); }
+
+private:
+    bool section_fits(std::uint64_t offset, std::uint64_t count, std::uint64_t element_size) const {
+        return offset % figure_file::alignment == 0
+            && offset >= sizeof(FigureFileHeader)
+            && offset <= _file.size()
+            && count <= (_file.size() - offset) / element_size;
+    }
+
+    MappedFile _file;
+    FigureColumns<T> _columns;
+};
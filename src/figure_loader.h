@@ -0,0 +1,200 @@
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include "array.h"
+#include "figure_store.h"
+#include "figures.h"
+#include "mapped_file.h"
+
+// Пакетная загрузка фигур из текста. Одна строка — одна фигура:
+//
+//     square    x1 y1 x2 y2 x3 y3 x4 y4
+//     rectangle x1 y1 x2 y2 x3 y3 x4 y4
+//     trapezoid x1 y1 x2 y2 x3 y3 x4 y4
+//     polygon   x1 y1 x2 y2 ... xN yN
+//
+// У многоугольника число вершин любое (не меньше одной): координаты идут
+// парами до конца строки. Столбец points в CSV из ReportWriter вместе с
+// видом фигуры даёт такую же запись.
+// Разделители — пробелы и табуляции; пустые строки и строки, начинающиеся
+// с '#', пропускаются. Некорректные строки не прерывают загрузку, а попадают
+// в список ошибок с номером строки (с единицы).
+
+struct LoadError {
+    size_t line;
+    std::string message;
+};
+
+template<class T>
+struct LoadResult {
+    Array<std::shared_ptr<Figure<T>>> figures;
+    Array<LoadError> errors;
+};
+
+template<class T>
+struct StoreLoadResult {
+    FigureStore<T> store;
+    Array<LoadError> errors;
+};
+
+namespace loader_detail {
+
+inline bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline const char* skip_blanks(const char* p, const char* end) {
+    while (p != end && is_blank(*p)) ++p;
+    return p;
+}
+
+inline const char* token_end(const char* p, const char* end) {
+    while (p != end && !is_blank(*p)) ++p;
+    return p;
+}
+
+inline bool parse_kind(std::string_view token, FigureKind& kind) {
+    if (token == "square") kind = FigureKind::Square;
+    else if (token == "rectangle") kind = FigureKind::Rectangle;
+    else if (token == "trapezoid") kind = FigureKind::Trapezoid;
+    else if (token == "polygon") kind = FigureKind::Polygon;
+    else return false;
+    return true;
+}
+
+} // namespace loader_detail
+
+// Разбирает текст и вызывает on_figure(kind, span<const Point<T>>) для каждой
+// корректной строки; ошибки добавляются в errors
+template<class T, class OnFigure>
+void parse_figure_records(std::string_view text, OnFigure&& on_figure, Array<LoadError>& errors) {
+    using namespace loader_detail;
+    constexpr size_t quad_coordinates = 8;
+    const char* p = text.data();
+    const char* const text_end = p + text.size();
+    // Буфер вершин общий для всех строк: память выделяется только под
+    // самый длинный многоугольник
+    Array<Point<T>> points;
+    points.reserve(quad_coordinates / 2);
+
+    for (size_t line = 1; p < text_end; ++line) {
+        const char* line_end = static_cast<const char*>(std::memchr(p, '\n', text_end - p));
+        if (!line_end) line_end = text_end;
+        const char* cur = skip_blanks(p, line_end);
+        const char* next_line = line_end == text_end ? text_end : line_end + 1;
+
+        if (cur == line_end || *cur == '#') {
+            p = next_line;
+            continue;
+        }
+
+        const char* kind_end = token_end(cur, line_end);
+        FigureKind kind;
+        if (!parse_kind(std::string_view(cur, kind_end - cur), kind)) {
+            errors.push_back({line, "unknown figure kind '" + std::string(cur, kind_end) + "'"});
+            p = next_line;
+            continue;
+        }
+        cur = kind_end;
+
+        // Четырёхугольник — ровно 8 координат, многоугольник — до конца строки
+        const bool polygon = kind == FigureKind::Polygon;
+        const size_t limit = polygon ? SIZE_MAX : quad_coordinates;
+        std::string error;
+        points.clear();
+        T x{};
+        size_t parsed = 0;
+        for (; parsed < limit; ++parsed) {
+            cur = skip_blanks(cur, line_end);
+            if (cur == line_end) break;
+            const char* value_end = token_end(cur, line_end);
+            T value;
+            auto [ptr, ec] = std::from_chars(cur, value_end, value);
+            if (ec != std::errc() || ptr != value_end) {
+                error = "invalid coordinate '" + std::string(cur, value_end) + "'";
+                break;
+            }
+            if (parsed % 2 == 0) {
+                x = value;
+            } else {
+                points.emplace_back(x, value);
+            }
+            cur = value_end;
+        }
+        if (error.empty()) {
+            if (!polygon && parsed < quad_coordinates) {
+                error = "expected 8 coordinates, got " + std::to_string(parsed);
+            } else if (polygon && parsed == 0) {
+                error = "expected at least 2 coordinates, got 0";
+            } else if (polygon && parsed % 2 != 0) {
+                error = "expected an even number of coordinates, got " + std::to_string(parsed);
+            }
+        }
+        if (error.empty() && skip_blanks(cur, line_end) != line_end) {
+            error = "unexpected trailing data";
+        }
+        if (!error.empty()) {
+            errors.push_back({line, std::move(error)});
+            p = next_line;
+            continue;
+        }
+
+        on_figure(kind, std::span<const Point<T>>(points.data(), points.size()));
+        p = next_line;
+    }
+}
+
+template<class T>
+LoadResult<T> parse_figures(std::string_view text) {
+    LoadResult<T> result;
+    // Примерная оценка: типичная запись занимает 30-40 байт
+    result.figures.reserve(text.size() / 32);
+    parse_figure_records<T>(text, [&](FigureKind kind, std::span<const Point<T>> points) {
+        result.figures.push_back(make_figure<T>(kind, points));
+    }, result.errors);
+    return result;
+}
+
+// Фигуры размещаются в resource (обычно FigureArena), который должен
+// пережить результат
+template<class T>
+LoadResult<T> parse_figures(std::string_view text, std::pmr::memory_resource* resource) {
+    LoadResult<T> result;
+    result.figures.reserve(text.size() / 32);
+    parse_figure_records<T>(text, [&](FigureKind kind, std::span<const Point<T>> points) {
+        result.figures.push_back(make_figure<T>(kind, points, resource));
+    }, result.errors);
+    return result;
+}
+
+template<class T>
+StoreLoadResult<T> parse_figure_store(std::string_view text) {
+    StoreLoadResult<T> result;
+    result.store.reserve(text.size() / 32, text.size() / 8);
+    parse_figure_records<T>(text, [&](FigureKind kind, std::span<const Point<T>> points) {
+        result.store.push_back(kind, points);
+    }, result.errors);
+    return result;
+}
+
+template<class T>
+LoadResult<T> load_figures(const std::string& path) {
+    MappedFile file(path);
+    return parse_figures<T>(file.view());
+}
+
+template<class T>
+LoadResult<T> load_figures(const std::string& path, std::pmr::memory_resource* resource) {
+    MappedFile file(path);
+    return parse_figures<T>(file.view(), resource);
+}
+
+template<class T>
+StoreLoadResult<T> load_figure_store(const std::string& path) {
+    MappedFile file(path);
+    return parse_figure_store<T>(file.view());
+}
@@ -0,0 +1,282 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "array.h"
+#include "figure.h"
+#include "figure_loader.h"
+#include "report_writer.h"
+#include "spsc_ring.h"
+
+// Потоковая обработка текста с фигурами (формат figure_loader.h):
+//
+//     чтение -> разбор -> вычисление -> отчёт
+//
+// Чтение выдаёт куски по chunk_size байт, обрезанные по последней целой
+// строке; разбор превращает кусок в пакет фигур; вычисление заполняет кэши
+// площади и центра; отчёт (в вызывающем потоке) пишет фигуры через
+// ReportWriter и суммирует площадь в порядке входа. Первые три стадии
+// работают в своих потоках, стадии связаны очередями SpscRing на
+// queue_capacity элементов: в памяти не больше нескольких кусков и пакетов
+// при любом размере входа, а чтение и вычисления идут одновременно.
+
+struct PipelineOptions {
+    size_t chunk_size = size_t(1) << 20;
+    size_t queue_capacity = 4;
+};
+
+// Время стадии делится на работу и ожидание входной и выходной очереди.
+// units — байты для чтения, фигуры для остальных стадий
+struct StageStats {
+    std::string_view name;
+    std::string_view unit;
+    size_t batches = 0;
+    size_t units = 0;
+    double busy_seconds = 0;
+    double input_wait_seconds = 0;
+    double output_wait_seconds = 0;
+};
+
+struct PipelineStats {
+    static constexpr size_t stage_count = 4;
+
+    StageStats stages[stage_count];
+    // queues[i] соединяет stages[i] и stages[i + 1]
+    QueueStats queues[stage_count - 1];
+    double seconds = 0;
+    double total_area = 0;
+    size_t figures = 0;
+    size_t errors = 0;
+};
+
+template<class T>
+struct FigureBatch {
+    Array<std::shared_ptr<Figure<T>>> figures;
+    Array<LoadError> errors;
+};
+
+namespace pipeline_detail {
+
+using Clock = std::chrono::steady_clock;
+
+inline double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Засекает время стадии от создания до разрушения и отдельно — время
+// внутри push и pop
+class StageTimer {
+public:
+    StageTimer(StageStats& stats, std::string_view name, std::string_view unit)
+        : _stats(stats), _start(Clock::now()) {
+        _stats.name = name;
+        _stats.unit = unit;
+    }
+
+    ~StageTimer() {
+        _stats.busy_seconds = seconds_since(_start) - _stats.input_wait_seconds - _stats.output_wait_seconds;
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    template<class Item>
+    bool pop(SpscRing<Item>& ring, Item& item) {
+        const Clock::time_point start = Clock::now();
+        const bool popped = ring.pop(item);
+        _stats.input_wait_seconds += seconds_since(start);
+        return popped;
+    }
+
+    template<class Item>
+    bool push(SpscRing<Item>& ring, Item item, size_t units) {
+        ++_stats.batches;
+        _stats.units += units;
+        const Clock::time_point start = Clock::now();
+        const bool pushed = ring.push(std::move(item));
+        _stats.output_wait_seconds += seconds_since(start);
+        return pushed;
+    }
+
+    void consumed(size_t units) {
+        ++_stats.batches;
+        _stats.units += units;
+    }
+
+private:
+    StageStats& _stats;
+    Clock::time_point _start;
+};
+
+// Кусок заканчивается последним переводом строки; если строка не уместилась
+// целиком, буфер удваивается
+inline void read_chunks(std::istream& in, size_t chunk_size, StageTimer& timer, SpscRing<std::string>& output) {
+    std::string carry;
+    bool eof = false;
+    while (!eof) {
+        std::string chunk(std::max(chunk_size, 2 * carry.size()), '\0');
+        std::memcpy(chunk.data(), carry.data(), carry.size());
+        in.read(chunk.data() + carry.size(), static_cast<std::streamsize>(chunk.size() - carry.size()));
+        if (in.bad()) throw std::runtime_error("Failed to read input");
+        const size_t filled = carry.size() + static_cast<size_t>(in.gcount());
+        eof = !in;
+
+        size_t cut = filled;
+        if (!eof) {
+            const size_t newline = std::string_view(chunk.data(), filled).rfind('\n');
+            cut = newline == std::string_view::npos ? 0 : newline + 1;
+        }
+        carry.assign(chunk.data() + cut, filled - cut);
+        if (cut == 0) continue;
+        chunk.resize(cut);
+        if (!timer.push(output, std::move(chunk), cut)) return;
+    }
+}
+
+} // namespace pipeline_detail
+
+// Прогоняет вход через конвейер. report.begin() и report.end() вызывает
+// вызывающий: суммарная площадь возвращается в статистике. on_error(const LoadError&)
+// вызывается в вызывающем потоке для некорректных строк, в порядке входа.
+// Исключение любой стадии останавливает остальные и пробрасывается после
+// их завершения (первым — исключение более ранней стадии).
+template<class T, class OnError>
+PipelineStats run_figure_pipeline(std::istream& in, ReportWriter<T>& report, OnError&& on_error,
+                                  const PipelineOptions& options = {}) {
+    using namespace pipeline_detail;
+    PipelineStats stats;
+    const Clock::time_point start = Clock::now();
+
+    SpscRing<std::string> chunks(options.queue_capacity);
+    SpscRing<FigureBatch<T>> parsed(options.queue_capacity);
+    SpscRing<FigureBatch<T>> computed(options.queue_capacity);
+    std::exception_ptr failures[PipelineStats::stage_count];
+    std::thread workers[PipelineStats::stage_count - 1];
+
+    // После стадии закрываются её очереди: это будит и останавливает
+    // соседей сверху и снизу, в том числе когда стадия завершилась с ошибкой
+    auto run_stage = [&](size_t stage, auto body, auto&... rings) {
+        try {
+            body();
+        } catch (...) {
+            failures[stage] = std::current_exception();
+        }
+        (rings.close(), ...);
+    };
+
+    try {
+        workers[0] = std::thread([&] {
+            run_stage(0, [&] {
+                StageTimer timer(stats.stages[0], "read", "bytes");
+                read_chunks(in, options.chunk_size, timer, chunks);
+            }, chunks);
+        });
+        workers[1] = std::thread([&] {
+            run_stage(1, [&] {
+                StageTimer timer(stats.stages[1], "parse", "figures");
+                std::string chunk;
+                size_t first_line = 1;
+                while (timer.pop(chunks, chunk)) {
+                    FigureBatch<T> batch;
+                    batch.figures.reserve(chunk.size() / 32);
+                    parse_figure_records<T>(chunk, [&](FigureKind kind, std::span<const Point<T>> points) {
+                        batch.figures.push_back(make_figure<T>(kind, points));
+                    }, batch.errors);
+                    // Номера строк в ошибках — от начала входа, а не куска
+                    for (LoadError& error : batch.errors) {
+                        error.line += first_line - 1;
+                    }
+                    first_line += static_cast<size_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+                    const size_t count = batch.figures.size();
+                    if (!timer.push(parsed, std::move(batch), count)) return;
+                }
+            }, chunks, parsed);
+        });
+        workers[2] = std::thread([&] {
+            run_stage(2, [&] {
+                StageTimer timer(stats.stages[2], "compute", "figures");
+                FigureBatch<T> batch;
+                while (timer.pop(parsed, batch)) {
+                    for (const auto& figure : batch.figures) {
+                        (void)figure->area();
+                        (void)figure->center();
+                    }
+                    const size_t count = batch.figures.size();
+                    if (!timer.push(computed, std::move(batch), count)) return;
+                }
+            }, parsed, computed);
+        });
+
+        StageTimer timer(stats.stages[3], "report", "figures");
+        FigureBatch<T> batch;
+        while (timer.pop(computed, batch)) {
+            for (const LoadError& error : batch.errors) {
+                on_error(error);
+            }
+            for (const auto& figure : batch.figures) {
+                report.write(*figure);
+                stats.total_area += figure->area();
+            }
+            stats.errors += batch.errors.size();
+            stats.figures += batch.figures.size();
+            timer.consumed(batch.figures.size());
+        }
+    } catch (...) {
+        failures[3] = std::current_exception();
+    }
+
+    chunks.close();
+    parsed.close();
+    computed.close();
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    for (const std::exception_ptr& failure : failures) {
+        if (failure) std::rethrow_exception(failure);
+    }
+
+    stats.queues[0] = chunks.stats();
+    stats.queues[1] = parsed.stats();
+    stats.queues[2] = computed.stats();
+    stats.seconds = seconds_since(start);
+    return stats;
+}
+
+// Таблица по стадиям: скорость — единиц в секунду собственной работы стадии
+// (без ожидания очередей); самая медленная стадия ограничивает конвейер
+inline void print_pipeline_stats(std::ostream& os, const PipelineStats& stats) {
+    const std::ios_base::fmtflags flags = os.flags();
+    const std::streamsize precision = os.precision();
+    os << "Pipeline: " << stats.figures << " figures, " << stats.errors << " errors, "
+       << std::fixed << std::setprecision(3) << stats.seconds << " s\n"
+       << std::setw(10) << "stage" << std::setw(10) << "batches" << std::setw(14) << "units"
+       << std::setw(10) << "busy s" << std::setw(11) << "wait in s" << std::setw(12) << "wait out s"
+       << std::setw(14) << "units/s" << "\n";
+    for (const StageStats& stage : stats.stages) {
+        const double rate = stage.busy_seconds > 0 ? static_cast<double>(stage.units) / stage.busy_seconds : 0.0;
+        os << std::setw(10) << stage.name << std::setw(10) << stage.batches << std::setw(14) << stage.units
+           << std::setw(10) << stage.busy_seconds << std::setw(11) << stage.input_wait_seconds
+           << std::setw(12) << stage.output_wait_seconds << std::setw(14) << std::setprecision(0) << rate
+           << std::setprecision(3) << " " << stage.unit << "\n";
+    }
+    os << std::setw(20) << "queue" << std::setw(10) << "capacity" << std::setw(10) << "pushes"
+       << std::setw(14) << "avg occupied" << std::setw(14) << "max occupied" << "\n";
+    for (size_t i = 0; i + 1 < PipelineStats::stage_count; ++i) {
+        const QueueStats& queue = stats.queues[i];
+        os << std::setw(20) << (std::string(stats.stages[i].name) + " -> " + std::string(stats.stages[i + 1].name))
+           << std::setw(10) << queue.capacity << std::setw(10) << queue.pushes
+           << std::setw(14) << std::setprecision(2) << queue.average_occupancy
+           << std::setw(14) << queue.max_occupancy << "\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
@@ -0,0 +1,380 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include "array.h"
+#include "figure.h"
+#include "thread_pool.h"
+
+// Упорядочивание коллекции фигур по площади или координате центра.
+// Ключ каждой фигуры вычисляется один раз и переводится в 64-битное
+// целое с тем же порядком; номера фигур сортируются поразрядно (LSD,
+// по байту за проход, проход пропускается, если байт у всех ключей
+// одинаков), затем указатели переставляются перемещением — фигуры не
+// копируются. Сортировка устойчива: фигуры с равными ключами сохраняют
+// исходный порядок. Перегрузки с ThreadPool считают ключи, гистограммы
+// и раскладку блоками по grain параллельно; результат от числа потоков
+// не зависит.
+
+enum class SortOrder { Ascending, Descending };
+
+namespace figure_sort {
+
+inline constexpr unsigned radix_bits = 8;
+inline constexpr size_t buckets = size_t(1) << radix_bits;
+inline constexpr unsigned passes = 64 / radix_bits;
+inline constexpr std::uint64_t sign_bit = std::uint64_t(1) << 63;
+
+// Беззнаковое целое с тем же порядком, что и у value
+inline std::uint64_t encode(double value) {
+    if (value == 0.0) value = 0.0;  // -0.0 и 0.0 равны
+    const std::uint64_t bits = std::bit_cast<std::uint64_t>(value);
+    return (bits & sign_bit) ? ~bits : bits | sign_bit;
+}
+
+template<std::integral I>
+std::uint64_t encode(I value) {
+    if constexpr (std::is_signed_v<I>) {
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(value)) ^ sign_bit;
+    } else {
+        return static_cast<std::uint64_t>(value);
+    }
+}
+
+template<class Key, class T>
+concept FigureKey = requires(Key key, const Figure<T>& figure) {
+    { encode(key(figure)) } -> std::same_as<std::uint64_t>;
+};
+
+// Вызывает body(begin, end) блоками по grain: в пуле или в текущем потоке
+template<class Body>
+void for_blocks(ThreadPool* pool, size_t count, size_t grain, Body&& body) {
+    if (pool) {
+        pool->parallel_for(count, grain, body);
+        return;
+    }
+    for (size_t begin = 0; begin < count; begin += grain) {
+        body(begin, std::min(count, begin + grain));
+    }
+}
+
+// По убыванию — те же ключи с инвертированными битами
+template<class T, class Key>
+Array<std::uint64_t> compute_keys(ThreadPool* pool, const Array<std::shared_ptr<Figure<T>>>& figures,
+                                  Key& key, SortOrder order, size_t grain) {
+    const std::uint64_t flip = order == SortOrder::Descending ? ~std::uint64_t(0) : 0;
+    Array<std::uint64_t> keys;
+    keys.resize(figures.size());
+    for_blocks(pool, figures.size(), grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            keys.unchecked(i) = encode(key(*figures.unchecked(i))) ^ flip;
+        }
+    });
+    return keys;
+}
+
+// Устойчивая поразрядная сортировка: номера элементов keys по возрастанию
+// ключа. keys при этом переупорядочиваются вместе с номерами.
+inline Array<size_t> radix_sort(ThreadPool* pool, Array<std::uint64_t>& keys, size_t grain) {
+    const size_t n = keys.size();
+    Array<size_t> index;
+    index.resize(n);
+    std::iota(index.begin(), index.end(), size_t(0));
+    if (n < 2) return index;
+
+    const size_t blocks = (n + grain - 1) / grain;
+    Array<std::uint64_t> keys_out;
+    keys_out.resize(n);
+    Array<size_t> index_out;
+    index_out.resize(n);
+    // counts[block * buckets + digit]: сначала количество, затем позиция записи
+    Array<size_t> counts;
+    counts.resize(blocks * buckets);
+
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        const unsigned shift = pass * radix_bits;
+        std::fill(counts.begin(), counts.end(), size_t(0));
+        for_blocks(pool, n, grain, [&](size_t begin, size_t end) {
+            size_t* count = counts.data() + begin / grain * buckets;
+            for (size_t i = begin; i < end; ++i) {
+                ++count[(keys.unchecked(i) >> shift) & (buckets - 1)];
+            }
+        });
+
+        // Байт у всех ключей одинаков — проход ничего не меняет
+        const size_t digit = (keys.unchecked(0) >> shift) & (buckets - 1);
+        size_t same = 0;
+        for (size_t b = 0; b < blocks; ++b) {
+            same += counts.unchecked(b * buckets + digit);
+        }
+        if (same == n) continue;
+
+        // Внутри разряда блоки идут по порядку — это сохраняет устойчивость
+        size_t offset = 0;
+        for (size_t d = 0; d < buckets; ++d) {
+            for (size_t b = 0; b < blocks; ++b) {
+                size_t& slot = counts.unchecked(b * buckets + d);
+                const size_t count = slot;
+                slot = offset;
+                offset += count;
+            }
+        }
+        for_blocks(pool, n, grain, [&](size_t begin, size_t end) {
+            size_t* position = counts.data() + begin / grain * buckets;
+            for (size_t i = begin; i < end; ++i) {
+                const std::uint64_t key = keys.unchecked(i);
+                const size_t to = position[(key >> shift) & (buckets - 1)]++;
+                keys_out.unchecked(to) = key;
+                index_out.unchecked(to) = index.unchecked(i);
+            }
+        });
+        keys.swap(keys_out);
+        index.swap(index_out);
+    }
+    return index;
+}
+
+// Ключ, который стоял бы на месте rank после сортировки: поразрядный
+// выбор от старшего байта к младшему. Ключи с другим префиксом
+// пропускаются, а когда подходящих остаётся не больше половины, они
+// переносятся в отдельный массив, так что следующие проходы короче.
+inline std::uint64_t select_key(ThreadPool* pool, const Array<std::uint64_t>& keys, size_t rank, size_t grain) {
+    Array<size_t> counts;
+    counts.resize((keys.size() + grain - 1) / grain * buckets);
+    Array<std::uint64_t> candidates;
+    const std::uint64_t* data = keys.data();
+    size_t size = keys.size();
+    std::uint64_t prefix = 0;
+    // Ключи data подходят, если (key & filter_mask) == (prefix & filter_mask)
+    std::uint64_t filter_mask = 0;
+    for (unsigned pass = passes; pass-- > 0;) {
+        const unsigned shift = pass * radix_bits;
+        const size_t blocks = (size + grain - 1) / grain;
+        const std::uint64_t filter = prefix & filter_mask;
+        std::fill(counts.begin(), counts.begin() + blocks * buckets, size_t(0));
+        for_blocks(pool, size, grain, [&](size_t begin, size_t end) {
+            size_t* count = counts.data() + begin / grain * buckets;
+            for (size_t i = begin; i < end; ++i) {
+                count[(data[i] >> shift) & (buckets - 1)] += (data[i] & filter_mask) == filter;
+            }
+        });
+
+        size_t digit = 0, total = 0;
+        for (; digit < buckets; ++digit) {
+            total = 0;
+            for (size_t b = 0; b < blocks; ++b) {
+                total += counts.unchecked(b * buckets + digit);
+            }
+            if (rank < total) break;
+            rank -= total;
+        }
+        prefix |= static_cast<std::uint64_t>(digit) << shift;
+        filter_mask |= static_cast<std::uint64_t>(buckets - 1) << shift;
+        if (pass == 0 || total > size / 2) continue;
+
+        // Блоки переносят подходящие ключи подряд, по порядку блоков
+        size_t offset = 0;
+        for (size_t b = 0; b < blocks; ++b) {
+            size_t& slot = counts.unchecked(b * buckets + digit);
+            const size_t count = slot;
+            slot = offset;
+            offset += count;
+        }
+        const std::uint64_t match = prefix & filter_mask;
+        Array<std::uint64_t> next;
+        next.resize(total);
+        for_blocks(pool, size, grain, [&](size_t begin, size_t end) {
+            size_t position = counts.unchecked(begin / grain * buckets + digit);
+            for (size_t i = begin; i < end; ++i) {
+                if ((data[i] & filter_mask) == match) next.unchecked(position++) = data[i];
+            }
+        });
+        candidates.swap(next);
+        data = candidates.data();
+        size = total;
+        filter_mask = 0;
+    }
+    return prefix;
+}
+
+// result[j] = figures[order[j]], указатели перемещаются
+template<class T>
+void permute(ThreadPool* pool, Array<std::shared_ptr<Figure<T>>>& figures, const Array<size_t>& order, size_t grain) {
+    Array<std::shared_ptr<Figure<T>>> result;
+    result.resize(order.size());
+    for_blocks(pool, order.size(), grain, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+            result.unchecked(j) = std::move(figures.unchecked(order.unchecked(j)));
+        }
+    });
+    figures.swap(result);
+}
+
+template<class T, class Key>
+void sort_by_key(ThreadPool* pool, Array<std::shared_ptr<Figure<T>>>& figures, Key& key, SortOrder order, size_t grain) {
+    grain = std::max<size_t>(1, grain);
+    Array<std::uint64_t> keys = compute_keys(pool, figures, key, order, grain);
+    permute(pool, figures, radix_sort(pool, keys, grain), grain);
+}
+
+// Первые k фигур в порядке order без сортировки остальных
+template<class T, class Key>
+Array<std::shared_ptr<Figure<T>>> top_k_by_key(ThreadPool* pool, const Array<std::shared_ptr<Figure<T>>>& figures,
+                                               size_t k, Key& key, SortOrder order, size_t grain) {
+    grain = std::max<size_t>(1, grain);
+    k = std::min(k, figures.size());
+    Array<std::shared_ptr<Figure<T>>> result;
+    if (k == 0) return result;
+
+    const Array<std::uint64_t> keys = compute_keys(pool, figures, key, order, grain);
+    const std::uint64_t threshold = select_key(pool, keys, k - 1, grain);
+    // Все ключи меньше порога и столько равных, сколько помещается (первые по номеру)
+    size_t less = 0;
+    for (std::uint64_t value : keys) less += value < threshold;
+    size_t equal = k - less;
+    Array<std::uint64_t> selected_keys;
+    selected_keys.reserve(k);
+    Array<size_t> selected;
+    selected.reserve(k);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const std::uint64_t value = keys.unchecked(i);
+        bool take = value < threshold;
+        if (value == threshold && equal > 0) {
+            take = true;
+            --equal;
+        }
+        if (take) {
+            selected_keys.push_back(value);
+            selected.push_back(i);
+        }
+    }
+
+    const Array<size_t> order_in_selected = radix_sort(nullptr, selected_keys, grain);
+    result.reserve(k);
+    for (size_t j : order_in_selected) {
+        result.push_back(figures.unchecked(selected.unchecked(j)));
+    }
+    return result;
+}
+
+// Как std::nth_element: на месте n — фигура, которая стояла бы там после
+// сортировки, перед ней ключи не больше, после — не меньше. Группы
+// меньших, равных и больших ключей сохраняют исходный порядок.
+template<class T, class Key>
+void nth_element_by_key(ThreadPool* pool, Array<std::shared_ptr<Figure<T>>>& figures, size_t n,
+                        Key& key, SortOrder order, size_t grain) {
+    if (n >= figures.size()) throw std::out_of_range("Index out of range");
+    grain = std::max<size_t>(1, grain);
+    const Array<std::uint64_t> keys = compute_keys(pool, figures, key, order, grain);
+    const std::uint64_t threshold = select_key(pool, keys, n, grain);
+
+    size_t less = 0, equal = 0;
+    for (std::uint64_t value : keys) {
+        less += value < threshold;
+        equal += value == threshold;
+    }
+    Array<size_t> positions;
+    positions.resize(keys.size());
+    size_t next_less = 0, next_equal = less, next_greater = less + equal;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const std::uint64_t value = keys.unchecked(i);
+        size_t& next = value < threshold ? next_less : value == threshold ? next_equal : next_greater;
+        positions.unchecked(next++) = i;
+    }
+    permute(pool, figures, positions, grain);
+}
+
+template<class T>
+struct AreaKey {
+    double operator()(const Figure<T>& figure) const { return figure.area(); }
+};
+
+template<class T>
+struct CenterXKey {
+    T operator()(const Figure<T>& figure) const { return figure.center().getX(); }
+};
+
+template<class T>
+struct CenterYKey {
+    T operator()(const Figure<T>& figure) const { return figure.center().getY(); }
+};
+
+} // namespace figure_sort
+
+// key(const Figure<T>&) возвращает число (целое или с плавающей точкой)
+template<class T, figure_sort::FigureKey<T> Key>
+void sort_by_key(ThreadPool& pool, Array<std::shared_ptr<Figure<T>>>& figures, Key key,
+                 SortOrder order = SortOrder::Ascending, size_t grain = ThreadPool::default_grain) {
+    figure_sort::sort_by_key(&pool, figures, key, order, grain);
+}
+
+template<class T, figure_sort::FigureKey<T> Key>
+void sort_by_key(Array<std::shared_ptr<Figure<T>>>& figures, Key key, SortOrder order = SortOrder::Ascending) {
+    figure_sort::sort_by_key(nullptr, figures, key, order, ThreadPool::default_grain);
+}
+
+template<class T>
+void sort_by_area(ThreadPool& pool, Array<std::shared_ptr<Figure<T>>>& figures,
+                  SortOrder order = SortOrder::Ascending, size_t grain = ThreadPool::default_grain) {
+    sort_by_key(pool, figures, figure_sort::AreaKey<T>(), order, grain);
+}
+
+template<class T>
+void sort_by_area(Array<std::shared_ptr<Figure<T>>>& figures, SortOrder order = SortOrder::Ascending) {
+    sort_by_key(figures, figure_sort::AreaKey<T>(), order);
+}
+
+template<class T>
+void sort_by_center_x(ThreadPool& pool, Array<std::shared_ptr<Figure<T>>>& figures,
+                      SortOrder order = SortOrder::Ascending, size_t grain = ThreadPool::default_grain) {
+    sort_by_key(pool, figures, figure_sort::CenterXKey<T>(), order, grain);
+}
+
+template<class T>
+void sort_by_center_x(Array<std::shared_ptr<Figure<T>>>& figures, SortOrder order = SortOrder::Ascending) {
+    sort_by_key(figures, figure_sort::CenterXKey<T>(), order);
+}
+
+template<class T>
+void sort_by_center_y(ThreadPool& pool, Array<std::shared_ptr<Figure<T>>>& figures,
+                      SortOrder order = SortOrder::Ascending, size_t grain = ThreadPool::default_grain) {
+    sort_by_key(pool, figures, figure_sort::CenterYKey<T>(), order, grain);
+}
+
+template<class T>
+void sort_by_center_y(Array<std::shared_ptr<Figure<T>>>& figures, SortOrder order = SortOrder::Ascending) {
+    sort_by_key(figures, figure_sort::CenterYKey<T>(), order);
+}
+
+// k фигур с наибольшей площадью по убыванию; исходная коллекция не меняется
+template<class T>
+Array<std::shared_ptr<Figure<T>>> top_k_by_area(ThreadPool& pool, const Array<std::shared_ptr<Figure<T>>>& figures,
+                                                size_t k, size_t grain = ThreadPool::default_grain) {
+    figure_sort::AreaKey<T> key;
+    return figure_sort::top_k_by_key(&pool, figures, k, key, SortOrder::Descending, grain);
+}
+
+template<class T>
+Array<std::shared_ptr<Figure<T>>> top_k_by_area(const Array<std::shared_ptr<Figure<T>>>& figures, size_t k) {
+    figure_sort::AreaKey<T> key;
+    return figure_sort::top_k_by_key(nullptr, figures, k, key, SortOrder::Descending, ThreadPool::default_grain);
+}
+
+template<class T>
+void nth_element_by_area(ThreadPool& pool, Array<std::shared_ptr<Figure<T>>>& figures, size_t n,
+                         size_t grain = ThreadPool::default_grain) {
+    figure_sort::AreaKey<T> key;
+    figure_sort::nth_element_by_key(&pool, figures, n, key, SortOrder::Ascending, grain);
+}
+
+template<class T>
+void nth_element_by_area(Array<std::shared_ptr<Figure<T>>>& figures, size_t n) {
+    figure_sort::AreaKey<T> key;
+    figure_sort::nth_element_by_key(nullptr, figures, n, key, SortOrder::Ascending, ThreadPool::default_grain);
+}
@@ -0,0 +1,259 @@
+#pragma once
+#include <cmath>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include "array.h"
+#include "figures.h"
+#include "simd_kernels.h"
+
+// Неизменяемое представление фигур в виде столбцов: вид фигуры, смещения
+// вершин и координаты x/y. Память принадлежит владельцу (FigureStore,
+// отображённый файл), сами вычисления от способа хранения не зависят.
+// Результаты совпадают с Square/Rectangle/Trapezoid. Если все фигуры —
+// четырёхугольники, площади и центры считаются SIMD-ядрами из simd_kernels.h.
+template<class T>
+struct FigureColumns {
+    using P = Point<T>;
+
+    std::span<const FigureKind> kinds;
+    // offsets[i] .. offsets[i + 1] — вершины i-й фигуры, offsets.size() == kinds.size() + 1
+    std::span<const size_t> offsets;
+    std::span<const T> xs;
+    std::span<const T> ys;
+    // Все фигуры имеют ровно 4 вершины: xs[4 * i + v], xs.size() == 4 * size()
+    bool all_quads = true;
+
+    size_t size() const noexcept { return kinds.size(); }
+
+    double area(size_t index) const {
+        if (index >= size()) throw std::out_of_range("FigureStore index out of range");
+        return area_unchecked(index);
+    }
+
+    P center(size_t index) const {
+        if (index >= size()) throw std::out_of_range("FigureStore index out of range");
+        return center_unchecked(index);
+    }
+
+    Array<double> areas() const {
+        Array<double> result;
+        if constexpr (simd::KernelCoordinate<T>) {
+            if (all_quads) {
+                result.resize(size());
+                // Ядро считает формулу Гаусса, для квадратов и прямоугольников
+                // площадь пересчитывается по их собственным формулам
+                simd::quad_areas(xs.data(), ys.data(), size(), result.data());
+                for (size_t i = 0; i < size(); ++i) {
+                    if (kinds[i] == FigureKind::Square || kinds[i] == FigureKind::Rectangle) {
+                        result.unchecked(i) = area_unchecked(i);
+                    }
+                }
+                return result;
+            }
+        }
+        result.reserve(size());
+        for (size_t i = 0; i < size(); ++i) {
+            result.push_back(area_unchecked(i));
+        }
+        return result;
+    }
+
+    Array<P> centers() const {
+        Array<P> result;
+        result.reserve(size());
+        if constexpr (simd::KernelCoordinate<T>) {
+            if (all_quads) {
+                Array<T> cx, cy;
+                cx.resize(size());
+                cy.resize(size());
+                simd::quad_centers(xs.data(), ys.data(), size(), cx.data(), cy.data());
+                for (size_t i = 0; i < size(); ++i) {
+                    result.emplace_back(cx.unchecked(i), cy.unchecked(i));
+                }
+                return result;
+            }
+        }
+        for (size_t i = 0; i < size(); ++i) {
+            result.push_back(center_unchecked(i));
+        }
+        return result;
+    }
+
+    double total_area() const {
+        double total = 0;
+        for (double area : areas()) {
+            total += area;
+        }
+        return total;
+    }
+
+    std::shared_ptr<Figure<T>> make_figure(size_t index) const {
+        if (index >= size()) throw std::out_of_range("FigureStore index out of range");
+        const auto [begin, count] = vertex_range(index);
+        Array<P> points;
+        points.reserve(count);
+        for (size_t v = begin; v < begin + count; ++v) {
+            points.emplace_back(xs[v], ys[v]);
+        }
+        return ::make_figure<T>(kinds[index], std::span<const P>(points.data(), points.size()));
+    }
+
+    // Первая вершина и число вершин фигуры. У четырёхугольников положение
+    // следует из номера (как в SIMD-ядрах); иначе смещения проверяются по
+    // столбцам координат: столбцы могут прийти из повреждённого файла
+    std::pair<size_t, size_t> vertex_range(size_t index) const {
+        if (all_quads) return {4 * index, 4};
+        const size_t begin = offsets[index], end = offsets[index + 1];
+        if (begin > end || end > xs.size() || end > ys.size()) {
+            throw std::runtime_error("Corrupted figure offsets");
+        }
+        return {begin, end - begin};
+    }
+
+    // Формулы совпадают с operator double() соответствующих фигур
+    double area_unchecked(size_t index) const {
+        const auto [begin, count] = vertex_range(index);
+        const T* x = xs.data() + begin;
+        const T* y = ys.data() + begin;
+
+        switch (kinds[index]) {
+            case FigureKind::Square: {
+                if (count < 2) throw std::out_of_range("Index out of range");
+                T side = std::abs(x[1] - x[0]);
+                return static_cast<double>(side * side);
+            }
+            case FigureKind::Rectangle: {
+                if (count < 3) throw std::out_of_range("Index out of range");
+                T length = std::abs(x[1] - x[0]);
+                T width = std::abs(y[2] - y[1]);
+                return static_cast<double>(length * width);
+            }
+            case FigureKind::Trapezoid:
+            case FigureKind::Polygon: {
+                double sum = 0.0;
+                for (size_t i = 0; i < count; ++i) {
+                    size_t j = (i + 1) % count;
+                    sum += static_cast<double>(x[i]) * static_cast<double>(y[j])
+                         - static_cast<double>(x[j]) * static_cast<double>(y[i]);
+                }
+                return std::abs(sum) * 0.5;
+            }
+        }
+        throw std::logic_error("Unknown figure kind");
+    }
+
+    P center_unchecked(size_t index) const {
+        const auto [begin, count] = vertex_range(index);
+        if (count == 0) return P();
+        T sum_x = 0, sum_y = 0;
+        for (size_t v = begin; v < begin + count; ++v) {
+            sum_x += xs[v];
+            sum_y += ys[v];
+        }
+        // Та же формула, что в center() фигур каждого вида
+        return P(vertex_mean(sum_x, count), vertex_mean(sum_y, count));
+    }
+};
+
+// Коллекция фигур в виде структуры массивов: вид фигуры, смещения вершин
+// и координаты x/y лежат в отдельных непрерывных массивах. Пакетные
+// операции идут по памяти линейно.
+template<class T>
+class FigureStore {
+public:
+    using P = Point<T>;
+
+    FigureStore() { _offsets.push_back(0); }
+
+    static FigureStore from_figures(const Array<std::shared_ptr<Figure<T>>>& figures) {
+        FigureStore store;
+        store.reserve(figures.size(), figures.size() * 4);
+        for (const auto& figure : figures) {
+            store.push_back(*figure);
+        }
+        return store;
+    }
+
+    void reserve(size_t figures, size_t vertices) {
+        _kinds.reserve(figures);
+        _offsets.reserve(figures + 1);
+        _xs.reserve(vertices);
+        _ys.reserve(vertices);
+    }
+
+    void push_back(FigureKind kind, std::span<const P> points) {
+        for (const P& point : points) {
+            _xs.push_back(point.getX());
+            _ys.push_back(point.getY());
+        }
+        _all_quads = _all_quads && points.size() == 4;
+        _kinds.push_back(kind);
+        _offsets.push_back(_xs.size());
+    }
+
+    void push_back(const Figure<T>& figure) {
+        for (size_t i = 0; i < figure.get_points_count(); ++i) {
+            const P& point = figure.get_point(i);
+            _xs.push_back(point.getX());
+            _ys.push_back(point.getY());
+        }
+        _all_quads = _all_quads && figure.get_points_count() == 4;
+        _kinds.push_back(figure.kind());
+        _offsets.push_back(_xs.size());
+    }
+
+    // Преобразует координаты всех вершин на месте, столбцы xs и ys — подряд
+    void transform(const AffineTransform& m) {
+        affine::transform_columns(m, _xs.data(), _ys.data(), _xs.size());
+    }
+
+    void clear() noexcept {
+        _kinds.clear();
+        _offsets.clear();
+        _offsets.push_back(0);
+        _xs.clear();
+        _ys.clear();
+        _all_quads = true;
+    }
+
+    size_t size() const noexcept { return _kinds.size(); }
+    bool empty() const noexcept { return _kinds.empty(); }
+    size_t vertex_count() const noexcept { return _xs.size(); }
+    bool all_quads() const noexcept { return _all_quads; }
+
+    FigureKind kind(size_t index) const { return _kinds[index]; }
+    size_t points_count(size_t index) const { return _offsets[index + 1] - _offsets[index]; }
+
+    std::span<const FigureKind> kinds() const noexcept { return {_kinds.data(), _kinds.size()}; }
+    std::span<const size_t> offsets() const noexcept { return {_offsets.data(), _offsets.size()}; }
+    std::span<const T> xs() const noexcept { return {_xs.data(), _xs.size()}; }
+    std::span<const T> ys() const noexcept { return {_ys.data(), _ys.size()}; }
+
+    FigureColumns<T> columns() const noexcept { return {kinds(), offsets(), xs(), ys(), _all_quads}; }
+
+    double area(size_t index) const { return columns().area(index); }
+    P center(size_t index) const { return columns().center(index); }
+    Array<double> areas() const { return columns().areas(); }
+    Array<P> centers() const { return columns().centers(); }
+    double total_area() const { return columns().total_area(); }
+
+    std::shared_ptr<Figure<T>> make_figure(size_t index) const { return columns().make_figure(index); }
+
+    Array<std::shared_ptr<Figure<T>>> to_figures() const {
+        Array<std::shared_ptr<Figure<T>>> figures;
+        figures.reserve(size());
+        for (size_t i = 0; i < size(); ++i) {
+            figures.push_back(make_figure(i));
+        }
+        return figures;
+    }
+
+private:
+    Array<FigureKind> _kinds;
+    Array<size_t> _offsets;
+    Array<T> _xs;
+    Array<T> _ys;
+    bool _all_quads = true;
+};
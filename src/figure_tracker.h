@@ -0,0 +1,127 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include "array.h"
+#include "compensated_sum.h"
+#include "figure.h"
+
+// Коллекция с отслеживанием изменений: площади и центры лежат в непрерывных
+// массивах и при очередном проходе пересчитываются только для фигур,
+// изменённых с прошлого раза. Изменения через modify() помечаются сразу,
+// изменения в обход коллекции находит detect_changes() по Figure::version().
+template<class T>
+class TrackedFigures {
+public:
+    using P = Point<T>;
+    using FigurePtr = std::shared_ptr<Figure<T>>;
+
+    TrackedFigures() = default;
+
+    explicit TrackedFigures(const Array<FigurePtr>& figures) {
+        _figures.reserve(figures.size());
+        for (const auto& figure : figures) {
+            push_back(figure);
+        }
+    }
+
+    void push_back(FigurePtr figure) {
+        if (!figure) throw std::invalid_argument("Null figure");
+        _figures.push_back(std::move(figure));
+        _areas.push_back(0.0);
+        _centers.emplace_back();
+        _versions.push_back(0);
+        _is_dirty.push_back(false);
+        mark_dirty(_figures.size() - 1);
+    }
+
+    size_t size() const noexcept { return _figures.size(); }
+    bool empty() const noexcept { return _figures.empty(); }
+
+    const Figure<T>& operator[](size_t index) const { return *_figures[index]; }
+
+    // Изменяет фигуру через func(Figure<T>&) и помечает её для пересчёта
+    template<class Func>
+    void modify(size_t index, Func&& func) {
+        Figure<T>& figure = *_figures[index];
+        mark_dirty(index);
+        std::forward<Func>(func)(figure);
+    }
+
+    void mark_dirty(size_t index) {
+        if (_is_dirty[index]) return;
+        _is_dirty.unchecked(index) = true;
+        _dirty.push_back(index);
+    }
+
+    // Помечает фигуры, чья версия изменилась с последнего пересчёта;
+    // возвращает количество новых помеченных фигур
+    size_t detect_changes() {
+        const size_t before = _dirty.size();
+        for (size_t i = 0; i < size(); ++i) {
+            if (_figures.unchecked(i)->version() != _versions.unchecked(i)) mark_dirty(i);
+        }
+        return _dirty.size() - before;
+    }
+
+    size_t dirty_count() const noexcept { return _dirty.size(); }
+
+    // Пересчитывает помеченные фигуры и возвращает их количество.
+    // Сумма площадей поправляется на разность старой и новой площади
+    // каждой помеченной фигуры — O(число помеченных), а не O(size()).
+    size_t refresh() {
+        const size_t recomputed = _dirty.size();
+        if (recomputed == 0) return 0;
+        bool resum = false;
+        for (size_t index : _dirty) {
+            const Figure<T>& figure = *_figures.unchecked(index);
+            const double before = _areas.unchecked(index);
+            const double after = figure.area();
+            _areas.unchecked(index) = after;
+            _centers.unchecked(index) = figure.center();
+            _versions.unchecked(index) = figure.version();
+            _is_dirty.unchecked(index) = false;
+            // Старую площадь inf или NaN из суммы не вычесть (как и в
+            // FigureCollection) — тогда сумма собирается заново
+            if (std::isfinite(before)) {
+                _total.add(after - before);
+            } else {
+                resum = true;
+            }
+        }
+        _dirty.clear();
+        if (resum) {
+            _total = CompensatedSum();
+            for (double area : _areas) {
+                _total.add(area);
+            }
+        }
+        return recomputed;
+    }
+
+    double total_area() {
+        refresh();
+        return _total.value();
+    }
+
+    const Array<double>& areas() {
+        refresh();
+        return _areas;
+    }
+
+    const Array<P>& centers() {
+        refresh();
+        return _centers;
+    }
+
+private:
+    Array<FigurePtr> _figures;
+    Array<double> _areas;
+    Array<P> _centers;
+    Array<std::uint64_t> _versions;
+    Array<bool> _is_dirty;
+    Array<size_t> _dirty;
+    CompensatedSum _total;
+};
@@ -0,0 +1,175 @@
+#pragma once
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+#include "array.h"
+#include "figures.h"
+
+// Закрытый набор фигур без виртуальных вызовов: тип известен из std::variant,
+// поэтому площадь и центр каждой фигуры компилятор может встроить.
+template<class T>
+using FigureVariant = std::variant<Square<T>, Rectangle<T>, Trapezoid<T>>;
+
+template<class T>
+class VariantFigures {
+public:
+    using value_type = FigureVariant<T>;
+    using P = Point<T>;
+
+    // Количество видов фигур в варианте
+    static constexpr size_t kinds_count = std::variant_size_v<FigureVariant<T>>;
+
+    static VariantFigures from_figures(const Array<std::shared_ptr<Figure<T>>>& figures) {
+        VariantFigures result;
+        result._figures.reserve(figures.size());
+        for (const auto& figure : figures) {
+            switch (figure->kind()) {
+                case FigureKind::Square: result.push_back(static_cast<const Square<T>&>(*figure)); break;
+                case FigureKind::Rectangle: result.push_back(static_cast<const Rectangle<T>&>(*figure)); break;
+                case FigureKind::Trapezoid: result.push_back(static_cast<const Trapezoid<T>&>(*figure)); break;
+                default: throw std::invalid_argument("Figure kind is not supported by VariantFigures");
+            }
+        }
+        return result;
+    }
+
+    template<class F>
+        requires std::is_constructible_v<FigureVariant<T>, F&&>
+    void push_back(F&& figure) {
+        _figures.emplace_back(std::forward<F>(figure));
+        _sorted = false;
+    }
+
+    size_t size() const noexcept { return _figures.size(); }
+    bool empty() const noexcept { return _figures.empty(); }
+
+    // Доступ к вариантам — только для чтения: замена альтернативы нарушила
+    // бы группы sort_by_kind(). Фигуры изменяются через visit, visit_each
+    // и for_each_of, которые передают конкретный тип фигуры
+    const FigureVariant<T>& operator[](size_t idx) const { return _figures[idx]; }
+
+    auto begin() const noexcept { return _figures.begin(); }
+    auto end() const noexcept { return _figures.end(); }
+
+    // Применяет visitor к фигуре idx
+    template<class Visitor>
+    decltype(auto) visit(size_t idx, Visitor&& visitor) {
+        return std::visit(std::forward<Visitor>(visitor), _figures[idx]);
+    }
+
+    template<class Visitor>
+    decltype(auto) visit(size_t idx, Visitor&& visitor) const {
+        return std::visit(std::forward<Visitor>(visitor), _figures[idx]);
+    }
+
+    // Применяет visitor к каждой фигуре в порядке хранения
+    template<class Visitor>
+    void visit_each(Visitor&& visitor) {
+        for (auto& figure : _figures) {
+            std::visit(visitor, figure);
+        }
+    }
+
+    template<class Visitor>
+    void visit_each(Visitor&& visitor) const {
+        for (const auto& figure : _figures) {
+            std::visit(visitor, figure);
+        }
+    }
+
+    // Группирует фигуры по виду (устойчиво, за O(n)), после чего
+    // операции проходят по каждой группе без ветвления на каждом элементе
+    void sort_by_kind() {
+        if (_sorted) return;
+        size_t counts[kinds_count] = {};
+        for (const auto& figure : _figures) ++counts[figure.index()];
+        _bucket_begin[0] = 0;
+        for (size_t k = 0; k < kinds_count; ++k) _bucket_begin[k + 1] = _bucket_begin[k] + counts[k];
+
+        Array<FigureVariant<T>> sorted;
+        sorted.reserve(_figures.size());
+        for (size_t k = 0; k < kinds_count; ++k) {
+            for (auto& figure : _figures) {
+                if (figure.index() == k) sorted.push_back(std::move(figure));
+            }
+        }
+        _figures = std::move(sorted);
+        _sorted = true;
+    }
+
+    bool sorted_by_kind() const noexcept { return _sorted; }
+
+    // Фигуры одного вида; доступно после sort_by_kind()
+    template<class F>
+    std::span<const FigureVariant<T>> bucket() const {
+        if (!_sorted) throw std::logic_error("VariantFigures is not sorted by kind");
+        constexpr size_t k = index_of<F>();
+        return {_figures.data() + _bucket_begin[k], _bucket_begin[k + 1] - _bucket_begin[k]};
+    }
+
+    // Применяет f(F&) ко всем фигурам вида F; тип известен статически
+    template<class F, class Func>
+    void for_each_of(Func&& func) {
+        if (_sorted) {
+            constexpr size_t k = index_of<F>();
+            for (size_t i = _bucket_begin[k]; i < _bucket_begin[k + 1]; ++i) {
+                func(*std::get_if<F>(&_figures.unchecked(i)));
+            }
+            return;
+        }
+        for (auto& figure : _figures) {
+            if (F* concrete = std::get_if<F>(&figure)) func(*concrete);
+        }
+    }
+
+    template<class F, class Func>
+    void for_each_of(Func&& func) const {
+        if (_sorted) {
+            for (const auto& figure : bucket<F>()) func(*std::get_if<F>(&figure));
+            return;
+        }
+        for (const auto& figure : _figures) {
+            if (const F* concrete = std::get_if<F>(&figure)) func(*concrete);
+        }
+    }
+
+    double total_area() const {
+        double total = 0;
+        if (_sorted) {
+            for_each_of<Square<T>>([&](const Square<T>& f) { total += f.area(); });
+            for_each_of<Rectangle<T>>([&](const Rectangle<T>& f) { total += f.area(); });
+            for_each_of<Trapezoid<T>>([&](const Trapezoid<T>& f) { total += f.area(); });
+            return total;
+        }
+        visit_each([&](const auto& figure) { total += figure.area(); });
+        return total;
+    }
+
+    Array<double> areas() const {
+        Array<double> result;
+        result.reserve(size());
+        visit_each([&](const auto& figure) { result.push_back(figure.area()); });
+        return result;
+    }
+
+    Array<P> centers() const {
+        Array<P> result;
+        result.reserve(size());
+        visit_each([&](const auto& figure) { result.push_back(figure.center()); });
+        return result;
+    }
+
+private:
+    template<class F, size_t I = 0>
+    static constexpr size_t index_of() {
+        static_assert(I < kinds_count, "Type is not an alternative of FigureVariant");
+        if constexpr (std::is_same_v<std::variant_alternative_t<I, FigureVariant<T>>, F>) return I;
+        else return index_of<F, I + 1>();
+    }
+
+    Array<FigureVariant<T>> _figures;
+    size_t _bucket_begin[kinds_count + 1] = {};
+    bool _sorted = false;
+};
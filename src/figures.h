@@ -1,31 +1,57 @@
 #pragma once
+#include <cmath>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
 #include "figure.h"
 
 // Квадрат
 template<class T>
-class Square : public Figure<T> {
+class Square final : public Figure<T> {
 public:
     Square() { std::cout << "Enter points for square (4 points in order):\n"; }
-    
-    Square(const Square<T>& other) : Figure<T>() {  
-        for (size_t i = 0; i < other.get_points_count(); ++i) {
-            this->add_point(other.get_point(i));
+
+    // Создание из готовых точек, без приглашения к вводу
+    explicit Square(std::span<const Point<T>> points,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : Figure<T>(points, resource) {}
+
+    FigureKind kind() const override { return FigureKind::Square; }
+
+    friend std::ostream& operator<<(std::ostream& os, const Square<T>& figure) {
+        os << "Square with " << figure.get_points_count() << " points:\n";
+        for (size_t i = 0; i < figure.get_points_count(); ++i) {
+            const auto& p = figure.get_point(i);
+            os << "Point " << i << ": (" << p.getX() << ", " << p.getY() << ")\n";
+        }
+        return os;
+    }
+
+    friend std::istream& operator>>(std::istream& is, Square<T>& square) {
+        for (int i = 0; i < 4; ++i) {
+            T x, y;
+            if (!(is >> x >> y)) break;
+            square.add_point(Point<T>(x, y));
         }
+        return is;
     }
 
-    Point<T> center() const override {
+protected:
+    Point<T> compute_center() const override {
         T sum_x = 0, sum_y = 0;
         size_t count = this->get_points_count();
-        
+        if (count == 0) return Point<T>();
+
         for (size_t i = 0; i < count; ++i) {
             sum_x += this->get_point(i).getX();
             sum_y += this->get_point(i).getY();
         }
-        
-        return Point<T>(sum_x / count, sum_y / count);
+
+        return Point<T>(vertex_mean(sum_x, count), vertex_mean(sum_y, count));
     }
 
-    operator double() override {
+    double compute_area() const override {
         // Для квадрата вычисляем площадь как квадрат длины стороны
         const auto& p1 = this->get_point(0);
         const auto& p2 = this->get_point(1);
@@ -34,8 +60,39 @@ public:
         return static_cast<double>(side * side);
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const Square<T>& figure) {
-        os << "Square with " << figure.get_points_count() << " points:\n";
+    // Площадь считается по стороне вдоль оси x: квадрат должен остаться
+    // квадратом со сторонами вдоль осей
+    bool area_scales_with(const AffineTransform& m) const override {
+        return m.preserves_axes() && std::abs(m.a) == std::abs(m.d);
+    }
+
+    // Стороны параллельны осям: достаточно сравнить с габаритом
+    void contains_batch(std::span<const Point<T>> query, bool* out) const override {
+        std::span<const Point<T>> vertices(this->points.data(), this->points.size());
+        if (containment::axis_aligned_box(vertices)) {
+            const BoundingBox<T> box = this->bounding_box();
+            containment::box_contains(box.min, box.max, query, out);
+        } else {
+            Figure<T>::contains_batch(query, out);
+        }
+    }
+};
+
+// Прямоугольник
+template<class T>
+class Rectangle final : public Figure<T> {
+public:
+    Rectangle() { std::cout << "Enter points for rectangle (4 points in order):\n"; }
+
+    // Создание из готовых точек, без приглашения к вводу
+    explicit Rectangle(std::span<const Point<T>> points,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : Figure<T>(points, resource) {}
+
+    FigureKind kind() const override { return FigureKind::Rectangle; }
+
+    friend std::ostream& operator<<(std::ostream& os, const Rectangle<T>& figure) {
+        os << "Rectangle with " << figure.get_points_count() << " points:\n";
         for (size_t i = 0; i < figure.get_points_count(); ++i) {
             const auto& p = figure.get_point(i);
             os << "Point " << i << ": (" << p.getX() << ", " << p.getY() << ")\n";
@@ -43,41 +100,30 @@ public:
         return os;
     }
 
-    friend std::istream& operator>>(std::istream& is, Square<T>& square) {
+    friend std::istream& operator>>(std::istream& is, Rectangle<T>& rectangle) {
         for (int i = 0; i < 4; ++i) {
             T x, y;
             if (!(is >> x >> y)) break;
-            square.add_point(Point<T>(x, y));
+            rectangle.add_point(Point<T>(x, y));
         }
         return is;
     }
-};
 
-// Прямоугольник
-template<class T>
-class Rectangle : public Figure<T> {
-public:
-    Rectangle() { std::cout << "Enter points for rectangle (4 points in order):\n"; }
-    
-    Rectangle(const Rectangle<T>& other) : Figure<T>() {  
-        for (size_t i = 0; i < other.get_points_count(); ++i) {
-            this->add_point(other.get_point(i));
-        }
-    }
-
-    Point<T> center() const override {
+protected:
+    Point<T> compute_center() const override {
         T sum_x = 0, sum_y = 0;
         size_t count = this->get_points_count();
-        
+        if (count == 0) return Point<T>();
+
         for (size_t i = 0; i < count; ++i) {
             sum_x += this->get_point(i).getX();
             sum_y += this->get_point(i).getY();
         }
-        
-        return Point<T>(sum_x / count, sum_y / count);
+
+        return Point<T>(vertex_mean(sum_x, count), vertex_mean(sum_y, count));
     }
 
-    operator double() override {
+    double compute_area() const override {
         // Для прямоугольника вычисляем площадь как длина * ширина
         const auto& p1 = this->get_point(0);
         const auto& p2 = this->get_point(1);
@@ -89,50 +135,69 @@ public:
         return static_cast<double>(length * width);
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const Rectangle<T>& figure) {
-        os << "Rectangle with " << figure.get_points_count() << " points:\n";
-        for (size_t i = 0; i < figure.get_points_count(); ++i) {
-            const auto& p = figure.get_point(i);
-            os << "Point " << i << ": (" << p.getX() << ", " << p.getY() << ")\n";
-        }
-        return os;
+    // Длина и ширина берутся вдоль осей
+    bool area_scales_with(const AffineTransform& m) const override {
+        return m.preserves_axes();
     }
 
-    friend std::istream& operator>>(std::istream& is, Rectangle<T>& rectangle) {
-        for (int i = 0; i < 4; ++i) {
-            T x, y;
-            if (!(is >> x >> y)) break;
-            rectangle.add_point(Point<T>(x, y));
+    // Стороны параллельны осям: достаточно сравнить с габаритом
+    void contains_batch(std::span<const Point<T>> query, bool* out) const override {
+        std::span<const Point<T>> vertices(this->points.data(), this->points.size());
+        if (containment::axis_aligned_box(vertices)) {
+            const BoundingBox<T> box = this->bounding_box();
+            containment::box_contains(box.min, box.max, query, out);
+        } else {
+            Figure<T>::contains_batch(query, out);
         }
-        return is;
     }
 };
 
 // Трапеция
 template<class T>
-class Trapezoid : public Figure<T> {
+class Trapezoid final : public Figure<T> {
 public:
     Trapezoid() { std::cout << "Enter points for trapezoid (4 points in order):\n"; }
-    
-    Trapezoid(const Trapezoid<T>& other) : Figure<T>() {  
-        for (size_t i = 0; i < other.get_points_count(); ++i) {
-            this->add_point(other.get_point(i));
+
+    // Создание из готовых точек, без приглашения к вводу
+    explicit Trapezoid(std::span<const Point<T>> points,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : Figure<T>(points, resource) {}
+
+    FigureKind kind() const override { return FigureKind::Trapezoid; }
+
+    friend std::ostream& operator<<(std::ostream& os, const Trapezoid<T>& figure) {
+        os << "Trapezoid with " << figure.get_points_count() << " points:\n";
+        for (size_t i = 0; i < figure.get_points_count(); ++i) {
+            const auto& p = figure.get_point(i);
+            os << "Point " << i << ": (" << p.getX() << ", " << p.getY() << ")\n";
+        }
+        return os;
+}
+
+    friend std::istream& operator>>(std::istream& is, Trapezoid<T>& trapezoid) {
+        for (int i = 0; i < 4; ++i) {
+            T x, y;
+            if (!(is >> x >> y)) break;
+            trapezoid.add_point(Point<T>(x, y));
         }
+        return is;
     }
 
-    Point<T> center() const override {
+protected:
+    Point<T> compute_center() const override {
         T sum_x = 0, sum_y = 0;
         size_t count = this->get_points_count();
-        
+        if (count == 0) return Point<T>();
+
         for (size_t i = 0; i < count; ++i) {
             sum_x += this->get_point(i).getX();
             sum_y += this->get_point(i).getY();
         }
-        
-        return Point<T>(sum_x / count, sum_y / count);
+
+        return Point<T>(vertex_mean(sum_x, count), vertex_mean(sum_y, count));
     }
 
-    operator double() override {
+    double compute_area() const override {
         // Для трапеции используем формулу площади через координаты (метод гаусса)
         const size_t n = this->get_points_count();
         double sum = 0.0;
@@ -150,21 +215,141 @@ public:
         return std::abs(sum) * 0.5;
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const Trapezoid<T>& figure) {
-        os << "Trapezoid with " << figure.get_points_count() << " points:\n";
+    // Формула Гаусса верна для любых вершин
+    bool area_scales_with(const AffineTransform&) const override {
+        return true;
+    }
+};
+
+// Многоугольник с произвольным числом вершин; через него фигуры
+// фиксированной арности (FixedPolygon) работают с интерфейсом Figure<T>.
+// Все величины считаются за один проход по вершинам.
+template<class T>
+class PolygonFigure final : public Figure<T> {
+public:
+    explicit PolygonFigure(std::span<const Point<T>> points,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : Figure<T>(points, resource) {}
+
+    FigureKind kind() const override { return FigureKind::Polygon; }
+
+    // Сумма длин рёбер, включая замыкающее
+    double perimeter() const {
+        const auto vertices = this->vertices();
+        if (vertices.size() < 2) return 0.0;
+        double sum = 0.0;
+        const Point<T>* prev = &vertices.back();
+        for (const Point<T>& point : vertices) {
+            const double dx = static_cast<double>(point.getX()) - static_cast<double>(prev->getX());
+            const double dy = static_cast<double>(point.getY()) - static_cast<double>(prev->getY());
+            sum += std::sqrt(dx * dx + dy * dy);
+            prev = &point;
+        }
+        return sum;
+    }
+
+    // Центр масс области (в отличие от center() — среднего вершин).
+    // Координаты берутся относительно первой вершины, чтобы не терять
+    // точность на далёких от начала координат фигурах. У вырожденного
+    // многоугольника нулевой площади — среднее вершин
+    Point<double> centroid() const {
+        const auto vertices = this->vertices();
+        if (vertices.empty()) return {};
+        const double x0 = static_cast<double>(vertices.front().getX());
+        const double y0 = static_cast<double>(vertices.front().getY());
+        double doubled_area = 0.0, sum_x = 0.0, sum_y = 0.0, mean_x = 0.0, mean_y = 0.0;
+        const Point<T>* prev = &vertices.back();
+        for (const Point<T>& point : vertices) {
+            const double xi = static_cast<double>(prev->getX()) - x0, yi = static_cast<double>(prev->getY()) - y0;
+            const double xj = static_cast<double>(point.getX()) - x0, yj = static_cast<double>(point.getY()) - y0;
+            const double cross = xi * yj - xj * yi;
+            doubled_area += cross;
+            sum_x += (xi + xj) * cross;
+            sum_y += (yi + yj) * cross;
+            mean_x += xj;
+            mean_y += yj;
+            prev = &point;
+        }
+        if (doubled_area == 0.0) {
+            const double n = static_cast<double>(vertices.size());
+            return Point<double>(x0 + mean_x / n, y0 + mean_y / n);
+        }
+        return Point<double>(x0 + sum_x / (3.0 * doubled_area), y0 + sum_y / (3.0 * doubled_area));
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const PolygonFigure<T>& figure) {
+        os << "Polygon with " << figure.get_points_count() << " points:\n";
         for (size_t i = 0; i < figure.get_points_count(); ++i) {
             const auto& p = figure.get_point(i);
             os << "Point " << i << ": (" << p.getX() << ", " << p.getY() << ")\n";
         }
         return os;
-}
+    }
 
-    friend std::istream& operator>>(std::istream& is, Trapezoid<T>& trapezoid) {
-        for (int i = 0; i < 4; ++i) {
-            T x, y;
-            if (!(is >> x >> y)) break;
-            trapezoid.add_point(Point<T>(x, y));
+protected:
+    Point<T> compute_center() const override {
+        T sum_x = 0, sum_y = 0;
+        const auto vertices = this->vertices();
+        if (vertices.empty()) return Point<T>();
+
+        for (const Point<T>& point : vertices) {
+            sum_x += point.getX();
+            sum_y += point.getY();
         }
-        return is;
+
+        return Point<T>(vertex_mean(sum_x, vertices.size()), vertex_mean(sum_y, vertices.size()));
+    }
+
+    double compute_area() const override {
+        // Формула Гаусса, как у трапеции: ребро (i, i + 1), замыкающее — последним
+        const auto vertices = this->vertices();
+        const size_t n = vertices.size();
+        if (n == 0) return 0.0;
+        double sum = 0.0;
+
+        for (size_t i = 0; i < n; ++i) {
+            const Point<T>& p = vertices[i];
+            const Point<T>& q = vertices[i + 1 == n ? 0 : i + 1];
+            sum += static_cast<double>(p.getX()) * static_cast<double>(q.getY())
+                 - static_cast<double>(q.getX()) * static_cast<double>(p.getY());
+        }
+
+        return std::abs(sum) * 0.5;
+    }
+
+    bool area_scales_with(const AffineTransform&) const override {
+        return true;
+    }
+
+private:
+    std::span<const Point<T>> vertices() const {
+        return std::span<const Point<T>>(this->points.data(), this->points.size());
+    }
+};
+
+// Создание фигуры нужного вида из готовых точек
+template<class T>
+std::shared_ptr<Figure<T>> make_figure(FigureKind kind, std::span<const Point<T>> points) {
+    switch (kind) {
+        case FigureKind::Square: return std::make_shared<Square<T>>(points);
+        case FigureKind::Rectangle: return std::make_shared<Rectangle<T>>(points);
+        case FigureKind::Trapezoid: return std::make_shared<Trapezoid<T>>(points);
+        case FigureKind::Polygon: return std::make_shared<PolygonFigure<T>>(points);
+    }
+    throw std::logic_error("Unknown figure kind");
+}
+
+// То же, но объект фигуры, счётчик ссылок и точки размещаются в resource
+// (например, в FigureArena); resource должен пережить все копии указателя
+template<class T>
+std::shared_ptr<Figure<T>> make_figure(FigureKind kind, std::span<const Point<T>> points,
+                                       std::pmr::memory_resource* resource) {
+    std::pmr::polymorphic_allocator<std::byte> alloc(resource);
+    switch (kind) {
+        case FigureKind::Square: return std::allocate_shared<Square<T>>(alloc, points, resource);
+        case FigureKind::Rectangle: return std::allocate_shared<Rectangle<T>>(alloc, points, resource);
+        case FigureKind::Trapezoid: return std::allocate_shared<Trapezoid<T>>(alloc, points, resource);
+        case FigureKind::Polygon: return std::allocate_shared<PolygonFigure<T>>(alloc, points, resource);
     }
-};
\ No newline at end of file
+    throw std::logic_error("Unknown figure kind");
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "figures.h"
+
+namespace fixed_detail {
+
+// Квадратный корень, пригодный для вычислений на этапе компиляции:
+// метод Ньютона сверху вниз, во время выполнения — std::sqrt. Для точных
+// квадратов результаты совпадают, в остальных случаях значение при
+// компиляции может отличаться от std::sqrt в последнем бите
+constexpr double sqrt(double value) {
+    if (!std::is_constant_evaluated()) return std::sqrt(value);
+    if (value <= 0.0) return 0.0;
+    double x = value > 1.0 ? value : 1.0;
+    while (true) {
+        double next = 0.5 * (x + value / x);
+        if (next >= x) return x;
+        x = next;
+    }
+}
+
+} // namespace fixed_detail
+
+// Многоугольник с числом вершин N, известным при компиляции. Вершины
+// лежат в std::array, циклы по ним разворачиваются свёрткой по индексам,
+// поэтому площадь, центр и периметр известных фигур вычисляются constexpr.
+// Во время выполнения результаты совпадают с PolygonFigure / Trapezoid на
+// тех же точках бит в бит; периметр, вычисленный при компиляции, — с
+// точностью до ошибки округления корня (см. fixed_detail::sqrt).
+template<class T, size_t N>
+    requires (N >= 3)
+class FixedPolygon {
+public:
+    using P = Point<T>;
+
+    constexpr FixedPolygon() = default;
+    constexpr explicit FixedPolygon(const std::array<P, N>& vertices) : _vertices(vertices) {}
+
+    static constexpr size_t size() noexcept { return N; }
+
+    constexpr const P& operator[](size_t index) const {
+        if (index >= N) throw std::out_of_range("Index out of range");
+        return _vertices[index];
+    }
+
+    constexpr const std::array<P, N>& vertices() const noexcept { return _vertices; }
+
+    // Формула Гаусса в том же порядке суммирования, что и у Trapezoid
+    constexpr double area() const {
+        double sum = shoelace(std::make_index_sequence<N>());
+        return (sum < 0 ? -sum : sum) * 0.5;
+    }
+
+    // Среднее вершин с округлением вниз, как в Figure<T>::center()
+    constexpr P center() const {
+        return center(std::make_index_sequence<N>());
+    }
+
+    // Рёбра в порядке PolygonFigure::perimeter: замыкающее (N - 1, 0) первым
+    constexpr double perimeter() const {
+        return edges(std::make_index_sequence<N>());
+    }
+
+private:
+    template<size_t... I>
+    constexpr double shoelace(std::index_sequence<I...>) const {
+        return (0.0 + ... + (x(I) * y((I + 1) % N) - x((I + 1) % N) * y(I)));
+    }
+
+    template<size_t... I>
+    constexpr P center(std::index_sequence<I...>) const {
+        T sum_x = (T(0) + ... + _vertices[I].getX());
+        T sum_y = (T(0) + ... + _vertices[I].getY());
+        return P(vertex_mean(sum_x, N), vertex_mean(sum_y, N));
+    }
+
+    template<size_t... I>
+    constexpr double edges(std::index_sequence<I...>) const {
+        return (0.0 + ... + edge_length((I + N - 1) % N, I));
+    }
+
+    constexpr double edge_length(size_t i, size_t j) const {
+        double dx = x(j) - x(i);
+        double dy = y(j) - y(i);
+        return fixed_detail::sqrt(dx * dx + dy * dy);
+    }
+
+    constexpr double x(size_t i) const { return static_cast<double>(_vertices[i].getX()); }
+    constexpr double y(size_t i) const { return static_cast<double>(_vertices[i].getY()); }
+
+    std::array<P, N> _vertices{};
+};
+
+template<class T>
+using FixedTriangle = FixedPolygon<T, 3>;
+
+template<class T>
+using FixedQuad = FixedPolygon<T, 4>;
+
+// Адаптер к интерфейсу Figure<T> для кода с динамическим полиморфизмом
+template<class T, size_t N>
+std::shared_ptr<Figure<T>> make_figure(const FixedPolygon<T, N>& polygon) {
+    return std::make_shared<PolygonFigure<T>>(std::span<const Point<T>>(polygon.vertices()));
+}
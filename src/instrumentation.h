@@ -0,0 +1,164 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+
+// Счётчики горячих путей по типам: выделения памяти, байты, копирования,
+// перемещения, перевыделения, перенесённые элементы и ошибки проверки
+// границ. Включаются при сборке с FIGURES_INSTRUMENTATION (опция CMake
+// с тем же именем); без неё макросы FIGURES_COUNT ничего не генерируют.
+
+namespace instrumentation {
+
+#ifdef FIGURES_INSTRUMENTATION
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+// Снимок счётчиков одного типа
+struct Snapshot {
+    std::string_view type;
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t copies = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t reallocations = 0;
+    std::uint64_t relocated = 0;
+    std::uint64_t bounds_failures = 0;
+};
+
+struct Counters {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> copies{0};
+    std::atomic<std::uint64_t> moves{0};
+    std::atomic<std::uint64_t> reallocations{0};
+    std::atomic<std::uint64_t> relocated{0};
+    std::atomic<std::uint64_t> bounds_failures{0};
+
+    Snapshot snapshot(std::string_view type) const noexcept {
+        constexpr auto relaxed = std::memory_order_relaxed;
+        return {type, allocations.load(relaxed), bytes.load(relaxed), copies.load(relaxed),
+                moves.load(relaxed), reallocations.load(relaxed), relocated.load(relaxed),
+                bounds_failures.load(relaxed)};
+    }
+
+    void reset() noexcept {
+        for (auto* counter : {&allocations, &bytes, &copies, &moves, &reallocations, &relocated, &bounds_failures}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+namespace detail {
+
+// Элемент реестра: счётчики типа регистрируются при первом обращении
+struct Entry {
+    std::string_view type;
+    Counters counters;
+    Entry* next = nullptr;
+};
+
+struct Registry {
+    std::mutex mutex;
+    Entry* head = nullptr;
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Имя типа из сигнатуры функции (без RTTI и без деманглинга)
+template<class T>
+constexpr std::string_view type_name() {
+#if defined(__clang__) || defined(__GNUC__)
+    std::string_view name = __PRETTY_FUNCTION__;
+    const size_t begin = name.find("T = ") + 4;
+    const size_t end = name.find_first_of(";]", begin);
+    return name.substr(begin, end - begin);
+#elif defined(_MSC_VER)
+    std::string_view name = __FUNCSIG__;
+    const size_t begin = name.find("type_name<") + 10;
+    const size_t end = name.rfind(">(void)");
+    return name.substr(begin, end - begin);
+#else
+    return "unknown";
+#endif
+}
+
+template<class T>
+Entry& entry() {
+    static Entry* instance = [] {
+        static Entry storage{type_name<T>(), {}, nullptr};
+        Registry& reg = registry();
+        std::lock_guard lock(reg.mutex);
+        storage.next = reg.head;
+        reg.head = &storage;
+        return &storage;
+    }();
+    return *instance;
+}
+
+} // namespace detail
+
+// Счётчики типа T (например, Array<int>)
+template<class T>
+Counters& counters() {
+    return detail::entry<T>().counters;
+}
+
+template<class T>
+Snapshot snapshot() {
+    detail::Entry& e = detail::entry<T>();
+    return e.counters.snapshot(e.type);
+}
+
+// Вызывает func(const Snapshot&) для каждого типа, у которого были события
+template<class Func>
+void for_each_snapshot(Func&& func) {
+    detail::Registry& reg = detail::registry();
+    std::lock_guard lock(reg.mutex);
+    for (detail::Entry* e = reg.head; e; e = e->next) {
+        func(e->counters.snapshot(e->type));
+    }
+}
+
+inline void reset() {
+    detail::Registry& reg = detail::registry();
+    std::lock_guard lock(reg.mutex);
+    for (detail::Entry* e = reg.head; e; e = e->next) {
+        e->counters.reset();
+    }
+}
+
+// Таблица счётчиков по всем зарегистрированным типам
+inline void dump(std::ostream& os) {
+    if constexpr (!enabled) {
+        os << "Instrumentation is disabled (build with FIGURES_INSTRUMENTATION)\n";
+        return;
+    }
+    os << "Instrumentation counters:\n"
+       << std::setw(12) << "allocs" << std::setw(14) << "bytes" << std::setw(10) << "copies"
+       << std::setw(10) << "moves" << std::setw(10) << "reallocs" << std::setw(12) << "relocated"
+       << std::setw(8) << "oob" << "  type\n";
+    for_each_snapshot([&](const Snapshot& s) {
+        os << std::setw(12) << s.allocations << std::setw(14) << s.bytes << std::setw(10) << s.copies
+           << std::setw(10) << s.moves << std::setw(10) << s.reallocations << std::setw(12) << s.relocated
+           << std::setw(8) << s.bounds_failures << "  " << s.type << "\n";
+    });
+}
+
+} // namespace instrumentation
+
+// FIGURES_COUNT(Type, counter, n): прибавляет n к счётчику типа Type
+#ifdef FIGURES_INSTRUMENTATION
+#define FIGURES_COUNT(Type, counter, n) \
+    (::instrumentation::counters<Type>().counter.fetch_add((n), std::memory_order_relaxed))
+#else
+#define FIGURES_COUNT(Type, counter, n) ((void)0)
+#endif
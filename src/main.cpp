@@ -1,46 +1,131 @@
 // src/main.cpp
+#include <exception>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <string_view>
 #include "figures.h"
 #include "array.h"
+#include "figure_algorithms.h"
+#include "figure_loader.h"
+#include "figure_pipeline.h"
+#include "instrumentation.h"
+#include "report_writer.h"
 
 using namespace std;
 
-int main() {
-    Array<shared_ptr<Figure<int>>> figures;
-    
+static void read_figures_interactively(Array<shared_ptr<Figure<int>>>& figures) {
     // Create square
     auto square = make_shared<Square<int>>();
     cout << "Enter 4 points for square (x y) in order:" << "\n";
     cin >> *square;
     figures.push_back(square);
-    
+
     // Create rectangle
     auto rectangle = make_shared<Rectangle<int>>();
     cout << "Enter 4 points for rectangle (x y) in order:" << "\n";
     cin >> *rectangle;
     figures.push_back(rectangle);
-    
+
     // Create trapezoid
     auto trapezoid = make_shared<Trapezoid<int>>();
     cout << "Enter 4 points for trapezoid (x y) in order:" << "\n";
     cin >> *trapezoid;
     figures.push_back(trapezoid);
-    
-    // Output information about figures
-    cout << "\nFigures information:" << "\n";
-    double total_area = 0;
-    for (size_t i = 0; i < figures.size(); ++i) {
-        cout << "Figure " << i + 1 << ":" << "\n";
-        cout << *figures[i];
-        double area = static_cast<double>(*figures[i]);
-        cout << "Area: " << area << "\n";
-        auto center = figures[i]->center();
-        cout << "Center: (" << center.getX() << ", " << center.getY() << ")" << "\n\n";
-        total_area += area;
+}
+
+static void print_usage(const char* program) {
+    cerr << "Usage: " << program << " [--input <file>] [--format text|csv|jsonl] [--stream]\n"
+         << "  without --input three figures are read from stdin\n"
+         << "  --stream reads, parses, computes and prints concurrently\n"
+         << "           (input from --input or stdin, stage statistics to stderr)\n";
+}
+
+// Конвейер из figure_pipeline.h: файл не загружается целиком
+static int run_stream(istream& in, const char* name, ReportFormat format) {
+    try {
+        ReportWriter<int> report(cout, format);
+        report.begin();
+        PipelineStats stats = run_figure_pipeline<int>(in, report, [&](const LoadError& error) {
+            cerr << name << ":" << error.line << ": " << error.message << "\n";
+        });
+        report.end(stats.total_area);
+        report.flush();
+        print_pipeline_stats(cerr, stats);
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    Array<shared_ptr<Figure<int>>> figures;
+    const char* input = nullptr;
+    ReportFormat format = ReportFormat::Text;
+    bool stream = false;
+
+    for (int i = 1; i < argc; ++i) {
+        string_view option = argv[i];
+        if (option == "--stream") {
+            stream = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (option == "--input") {
+            input = argv[++i];
+        } else if (option != "--format" || !parse_report_format(argv[++i], format)) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (stream) {
+        ifstream file;
+        if (input) {
+            file.open(input, ios::binary);
+            if (!file) {
+                cerr << "Cannot open file: " << input << "\n";
+                return 1;
+            }
+        }
+        if (run_stream(input ? file : cin, input ? input : "<stdin>", format) != 0) return 1;
+    } else {
+        if (!input) {
+            read_figures_interactively(figures);
+        } else {
+            try {
+                LoadResult<int> loaded = load_figures<int>(input);
+                for (const LoadError& error : loaded.errors) {
+                    cerr << input << ":" << error.line << ": " << error.message << "\n";
+                }
+                figures = std::move(loaded.figures);
+            } catch (const exception& e) {
+                cerr << e.what() << "\n";
+                return 1;
+            }
+        }
+
+        // Output information about figures
+        try {
+            ReportWriter<int> report(cout, format);
+            report.begin();
+            report.write(figures);
+            report.end(total_area(figures));
+            report.flush();
+        } catch (const exception& e) {
+            cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    // Счётчики выводятся только в сборке с FIGURES_INSTRUMENTATION
+    if constexpr (instrumentation::enabled) {
+        instrumentation::dump(cerr);
     }
-    
-    cout << "Total area of all figures: " << total_area << "\n";
-    
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FIGURES_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <memory>
+#endif
+
+// Файл, отображённый в память только для чтения. Там, где mmap недоступен,
+// файл целиком читается в буфер — интерфейс тот же.
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string& path) {
+#ifdef FIGURES_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open file: " + path);
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat file: " + path);
+        }
+        _size = static_cast<size_t>(info.st_size);
+        if (_size > 0) {
+            void* address = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map file: " + path);
+            }
+            ::madvise(address, _size, MADV_SEQUENTIAL);
+            _data = static_cast<const char*>(address);
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("Cannot open file: " + path);
+        _size = static_cast<size_t>(in.tellg());
+        _buffer = std::make_unique<char[]>(_size);
+        in.seekg(0);
+        in.read(_buffer.get(), static_cast<std::streamsize>(_size));
+        _data = _buffer.get();
+#endif
+    }
+
+    ~MappedFile() { unmap(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            MappedFile tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    const char* data() const noexcept { return _data; }
+    size_t size() const noexcept { return _size; }
+    std::string_view view() const noexcept { return {_data, _size}; }
+
+    void swap(MappedFile& other) noexcept {
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+#ifndef FIGURES_HAS_MMAP
+        std::swap(_buffer, other._buffer);
+#endif
+    }
+
+private:
+    void unmap() noexcept {
+#ifdef FIGURES_HAS_MMAP
+        if (_data) ::munmap(const_cast<char*>(_data), _size);
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+
+    const char* _data = nullptr;
+    size_t _size = 0;
+#ifndef FIGURES_HAS_MMAP
+    std::unique_ptr<char[]> _buffer;
+#endif
+};
@@ -1,6 +1,15 @@
 #pragma once
 #include <type_traits>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "instrumentation.h"
 
 template<class T>
 concept Pointable = std::is_scalar_v<T>;
@@ -8,17 +17,17 @@ concept Pointable = std::is_scalar_v<T>;
 template<Pointable T>
 class Point {
 public:
-    Point(T x = T(), T y = T()) : _x(x), _y(y) {}
+    constexpr Point(T x = T(), T y = T()) : _x(x), _y(y) {}
 
-    T getX() const {return _x;}
-    T getY() const {return _y;}
+    constexpr T getX() const {return _x;}
+    constexpr T getY() const {return _y;}
     
     // Операции для вычислений
-    Point<T> operator+(const Point<T>& other) const {
+    constexpr Point<T> operator+(const Point<T>& other) const {
         return Point<T>(_x + other._x, _y + other._y);
     }
     
-    Point<T> operator/(T divisor) const {
+    constexpr Point<T> operator/(T divisor) const {
         return Point<T>(_x / divisor, _y / divisor);
     }
     
@@ -27,77 +36,273 @@ private:
     T _y;
 };
 
-template<class P>
+// До InlineCapacity точек хранятся внутри объекта; большие наборы
+// размещаются в std::pmr::memory_resource (по умолчанию — в куче).
+// Буфер в ресурсе разделяется между копиями (копирование при записи):
+// перед первым изменением через неконстантный доступ копия получает
+// собственный буфер. Счётчик владельцев атомарный, поэтому копии можно
+// читать, копировать и уничтожать из разных потоков.
+//
+// Неконстантные data(), begin(), end(), operator[] и emplace_back отдают
+// наружу ссылки для записи. После этого буфер больше не разделяется:
+// копии получают свои точки, иначе запись по ранее взятой ссылке изменила
+// бы и копию. Разделение возвращается, когда буфер заменяется новым.
+template<class P, size_t InlineCapacity = 4>
 class PointContainer {
-private:
-    struct Node {
-        std::unique_ptr<P> point;
-        Node* next;
-        Node(std::unique_ptr<P> p) : point(std::move(p)), next(nullptr) {}
-    };
+public:
+    using value_type = P;
+    using iterator = P*;
+    using const_iterator = const P*;
 
-    Node* head = nullptr;
-    size_t _size = 0;
+    PointContainer() noexcept : PointContainer(std::pmr::get_default_resource()) {}
 
-public:
-    PointContainer() = default;
+    explicit PointContainer(std::pmr::memory_resource* resource) noexcept
+        : _data(inline_data()), _resource(resource) {}
 
     ~PointContainer() {
-        while (head) {
-            Node* temp = head;
-            head = head->next;
-            delete temp;
+        release();
+    }
+
+    // Копия использует тот же ресурс и разделяет с оригиналом буфер в нём
+    PointContainer(const PointContainer& other) : PointContainer(other, other._resource) {}
+
+    // Буфер разделяется, только если ресурсы равны; иначе точки копируются
+    PointContainer(const PointContainer& other, std::pmr::memory_resource* resource)
+        : _data(inline_data()), _resource(resource)
+    {
+        FIGURES_COUNT(PointContainer, copies, 1);
+        if (!other.is_inline() && !other._unshareable && *_resource == *other._resource) {
+            other.header()->owners.fetch_add(1, std::memory_order_relaxed);
+            _data = other._data;
+            _size = other._size;
+            _capacity = other._capacity;
+        } else {
+            reserve(other._size);
+            for (; _size < other._size; ++_size) {
+                ::new (static_cast<void*>(_data + _size)) P(other._data[_size]);
+            }
         }
     }
 
-    // Умные указатели запрещают копирование
-    PointContainer(const PointContainer&) = delete;
-    PointContainer& operator=(const PointContainer&) = delete;
+    // Ресурс памяти не меняется
+    PointContainer& operator=(const PointContainer& other) {
+        if (this != &other) {
+            PointContainer copy(other, _resource);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
 
-    // Разрешаем перемещение
-    PointContainer(PointContainer&& other) noexcept
-        : head(other.head), _size(other._size)
+    // Разрешаем перемещение; ресурс памяти переходит вместе с буфером
+    PointContainer(PointContainer&& other) noexcept(std::is_nothrow_move_constructible_v<P>)
+        : _data(inline_data()), _resource(other._resource)
     {
-        other.head = nullptr;
-        other._size = 0;
+        FIGURES_COUNT(PointContainer, moves, 1);
+        steal(other);
     }
 
-    // Перемещающий оператор присваивания
-    PointContainer& operator=(PointContainer&& other) noexcept {
+    // Перемещающий оператор присваивания: ресурс памяти не меняется,
+    // при разных ресурсах точки перемещаются поштучно (нехватка памяти
+    // в этом случае завершает программу, как в перемещающем конструкторе)
+    PointContainer& operator=(PointContainer&& other) noexcept(std::is_nothrow_move_constructible_v<P>) {
         if (this != &other) {
-            while (head) { Node* t = head; head = head->next; delete t; }
-            head = other.head;
-            _size = other._size;
-            other.head = nullptr;
-            other._size = 0;
+            FIGURES_COUNT(PointContainer, moves, 1);
+            release();
+            steal(other);
         }
         return *this;
     }
 
+    std::pmr::memory_resource* resource() const noexcept { return _resource; }
+
+    // Буфер принадлежит ещё и другим копиям
+    bool is_shared() const noexcept {
+        return !is_inline() && header()->owners.load(std::memory_order_acquire) > 1;
+    }
+
+    // Совместимость со старым интерфейсом: точка копируется во внутренний буфер
     void push_back(std::unique_ptr<P> point) {
-        Node* newNode = new Node(std::move(point));
-        if (!head) head = newNode;
-        else {
-            Node* cur = head;
-            while (cur->next) cur = cur->next;
-            cur->next = newNode;
-        }
-        ++_size;
+        if (!point) throw std::invalid_argument("Null point");
+        push_back(std::move(*point));
     }
 
-    size_t size() const { return _size; }
+    void push_back(const P& point) { append(point); }
+    void push_back(P&& point) { append(std::move(point)); }
+
+    template<class... Args>
+    P& emplace_back(Args&&... args) {
+        P& point = append(std::forward<Args>(args)...);
+        _unshareable = true;
+        return point;
+    }
+
+    void reserve(size_t new_capacity) {
+        if (new_capacity <= _capacity) return;
+        relocate_to(allocate(new_capacity), new_capacity);
+    }
+
+    size_t size() const noexcept { return _size; }
+    size_t capacity() const noexcept { return _capacity; }
+    bool empty() const noexcept { return _size == 0; }
+
+    // Неконстантный доступ отделяет разделяемый буфер
+    P* data() {
+        detach();
+        _unshareable = true;
+        return _data;
+    }
+    const P* data() const noexcept { return _data; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + _size; }
+    const_iterator begin() const noexcept { return _data; }
+    const_iterator end() const noexcept { return _data + _size; }
 
     P& operator[](size_t index) {
-        if (index >= _size) throw std::out_of_range("Index out of range");
-        Node* cur = head;
-        for (size_t i = 0; i < index; ++i) cur = cur->next;
-        return *(cur->point);
+        if (index >= _size) out_of_range();
+        return data()[index];
     }
 
     const P& operator[](size_t index) const {
-        if (index >= _size) throw std::out_of_range("Index out of range");
-        Node* cur = head;
-        for (size_t i = 0; i < index; ++i) cur = cur->next;
-        return *(cur->point);
+        if (index >= _size) out_of_range();
+        return _data[index];
     }
+
+    // Изменение точек на месте через func(P* data, size_t size) без выдачи
+    // ссылок наружу: func не сохраняет указатель, поэтому копии, сделанные
+    // после этого, снова разделяют буфер
+    template<class Func>
+    void modify(Func&& func) {
+        detach();
+        std::forward<Func>(func)(_data, _size);
+    }
+
+private:
+    template<class... Args>
+    P& append(Args&&... args) {
+        if (_size == _capacity || is_shared()) {
+            // Новый элемент строится до переноса старых: args могут ссылаться на них
+            size_t new_capacity = _size == _capacity ? _capacity * 2 : _capacity;
+            P* new_data = allocate(new_capacity);
+            try {
+                ::new (static_cast<void*>(new_data + _size)) P(std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(new_data, new_capacity);
+                throw;
+            }
+            relocate_to(new_data, new_capacity);
+        } else {
+            ::new (static_cast<void*>(_data + _size)) P(std::forward<Args>(args)...);
+        }
+        return _data[_size++];
+    }
+
+    // Заголовок буфера в ресурсе: число контейнеров, разделяющих буфер.
+    // Все владельцы буфера хранят одинаковые _size и _capacity
+    struct Header {
+        std::atomic<size_t> owners;
+    };
+
+    static constexpr size_t header_size = (sizeof(Header) + alignof(P) - 1) / alignof(P) * alignof(P);
+    static constexpr size_t block_alignment = std::max(alignof(Header), alignof(P));
+
+    P* inline_data() noexcept { return reinterpret_cast<P*>(_inline); }
+    bool is_inline() const noexcept { return _data == reinterpret_cast<const P*>(_inline); }
+
+    Header* header() const noexcept {
+        return std::launder(reinterpret_cast<Header*>(reinterpret_cast<unsigned char*>(_data) - header_size));
+    }
+
+    [[noreturn]] static void out_of_range() {
+        FIGURES_COUNT(PointContainer, bounds_failures, 1);
+        throw std::out_of_range("Index out of range");
+    }
+
+    P* allocate(size_t count) {
+        FIGURES_COUNT(PointContainer, allocations, 1);
+        FIGURES_COUNT(PointContainer, bytes, count * sizeof(P));
+        void* block = _resource->allocate(header_size + count * sizeof(P), block_alignment);
+        ::new (block) Header{1};
+        return reinterpret_cast<P*>(static_cast<unsigned char*>(block) + header_size);
+    }
+
+    void deallocate(P* ptr, size_t count) noexcept {
+        unsigned char* block = reinterpret_cast<unsigned char*>(ptr) - header_size;
+        std::destroy_at(std::launder(reinterpret_cast<Header*>(block)));
+        _resource->deallocate(block, header_size + count * sizeof(P), block_alignment);
+    }
+
+    // Отказ от буфера: точки разрушает последний владелец. Контейнер
+    // становится пустым со встроенным буфером
+    void release() noexcept {
+        if (is_inline()) {
+            std::destroy_n(_data, _size);
+        } else if (header()->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::destroy_n(_data, _size);
+            deallocate(_data, _capacity);
+        }
+        _data = inline_data();
+        _size = 0;
+        _capacity = InlineCapacity;
+        _unshareable = false;
+    }
+
+    void detach() {
+        if (is_shared()) relocate_to(allocate(_capacity), _capacity);
+    }
+
+    // Переносит текущие элементы в new_data (первые _size слотов ещё не заняты);
+    // из разделяемого буфера элементы копируются
+    void relocate_to(P* new_data, size_t new_capacity) {
+        FIGURES_COUNT(PointContainer, reallocations, 1);
+        FIGURES_COUNT(PointContainer, relocated, _size);
+        const bool shared = is_shared();
+        const size_t size = _size;
+        size_t moved = 0;
+        try {
+            for (; moved < size; ++moved) {
+                if (shared) ::new (static_cast<void*>(new_data + moved)) P(std::as_const(_data[moved]));
+                else ::new (static_cast<void*>(new_data + moved)) P(std::move_if_noexcept(_data[moved]));
+            }
+        } catch (...) {
+            std::destroy_n(new_data, moved);
+            deallocate(new_data, new_capacity);
+            throw;
+        }
+        release();
+        _data = new_data;
+        _size = size;
+        _capacity = new_capacity;
+    }
+
+    // Ожидает пустой контейнер со встроенным буфером
+    void steal(PointContainer& other) {
+        if (other.is_inline() || !(*_resource == *other._resource)) {
+            reserve(other._size);
+            const bool shared = other.is_shared();
+            for (; _size < other._size; ++_size) {
+                if (shared) ::new (static_cast<void*>(_data + _size)) P(std::as_const(other._data[_size]));
+                else ::new (static_cast<void*>(_data + _size)) P(std::move(other._data[_size]));
+            }
+            other.release();
+        } else {
+            _data = other._data;
+            _size = other._size;
+            _capacity = other._capacity;
+            _unshareable = other._unshareable;
+            other._data = other.inline_data();
+            other._size = 0;
+            other._capacity = InlineCapacity;
+            other._unshareable = false;
+        }
+    }
+
+    // Встроенный буфер: четырёхугольники не выделяют память в куче
+    alignas(P) unsigned char _inline[InlineCapacity * sizeof(P)];
+    P* _data;
+    size_t _size = 0;
+    size_t _capacity = InlineCapacity;
+    std::pmr::memory_resource* _resource;
+    // Наружу отданы ссылки для записи в буфер
+    bool _unshareable = false;
 };
\ No newline at end of file
@@ -0,0 +1,260 @@
+#pragma once
+#include <charconv>
+#include <concepts>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include "array.h"
+#include "figure.h"
+
+// Отчёт о фигурах: точки, площадь и центр. Числа форматируются через
+// std::to_chars в собственный буфер, который сбрасывается в поток целыми
+// блоками, — без вставок в std::ostream на каждое значение.
+//
+// Text      — тот же текст, что выводили operator<< и main.cpp (байт в байт:
+//             числа с плавающей точкой как у std::ostream по умолчанию, %g)
+// Csv       — index,kind,area,center_x,center_y,points; points — координаты
+//             через пробел
+// JsonLines — один объект JSON на строку; числа с плавающей точкой в
+//             кратчайшей точной записи, бесконечности и NaN — null
+
+enum class ReportFormat { Text, Csv, JsonLines };
+
+// Имя формата из командной строки: text, csv или jsonl
+inline bool parse_report_format(std::string_view name, ReportFormat& format) {
+    if (name == "text") format = ReportFormat::Text;
+    else if (name == "csv") format = ReportFormat::Csv;
+    else if (name == "jsonl") format = ReportFormat::JsonLines;
+    else return false;
+    return true;
+}
+
+namespace report_detail {
+
+// Имена видов совпадают с ключевыми словами загрузчика
+inline std::string_view kind_name(FigureKind kind) {
+    switch (kind) {
+        case FigureKind::Square: return "square";
+        case FigureKind::Rectangle: return "rectangle";
+        case FigureKind::Trapezoid: return "trapezoid";
+        default: return "polygon";
+    }
+}
+
+// Запас под одно число: самая длинная запись double — 24 символа
+inline constexpr size_t max_number_size = 32;
+
+} // namespace report_detail
+
+template<class T>
+class ReportWriter {
+public:
+    static constexpr size_t default_buffer_size = size_t(1) << 20;
+
+    explicit ReportWriter(std::ostream& os, ReportFormat format = ReportFormat::Text,
+                          size_t buffer_size = default_buffer_size)
+        : _os(os), _format(format) {
+        _buffer.resize(std::max(buffer_size, report_detail::max_number_size));
+    }
+
+    // Ошибка потока при последнем сбросе в деструкторе не сообщается:
+    // чтобы её обработать, нужно вызвать flush() явно
+    ~ReportWriter() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    ReportFormat format() const noexcept { return _format; }
+    size_t figures_written() const noexcept { return _index; }
+
+    // Заголовок «Figures information:» или строка с именами столбцов CSV
+    void begin() {
+        switch (_format) {
+            case ReportFormat::Text: put("\nFigures information:\n"); break;
+            case ReportFormat::Csv: put("index,kind,area,center_x,center_y,points\n"); break;
+            case ReportFormat::JsonLines: break;
+        }
+    }
+
+    // Фигуры нумеруются с единицы в порядке записи
+    void write(const Figure<T>& figure) {
+        ++_index;
+        switch (_format) {
+            case ReportFormat::Text: write_text(figure); break;
+            case ReportFormat::Csv: write_csv(figure); break;
+            case ReportFormat::JsonLines: write_json(figure); break;
+        }
+    }
+
+    void write(const Array<std::shared_ptr<Figure<T>>>& figures) {
+        for (const auto& figure : figures) {
+            write(*figure);
+        }
+    }
+
+    // Итоговая строка с суммарной площадью (в CSV не выводится)
+    void end(double total_area) {
+        switch (_format) {
+            case ReportFormat::Text:
+                put("Total area of all figures: ");
+                text_number(total_area);
+                put('\n');
+                break;
+            case ReportFormat::Csv: break;
+            case ReportFormat::JsonLines:
+                put("{\"total_area\":");
+                json_number(total_area);
+                put("}\n");
+                break;
+        }
+    }
+
+    void flush() {
+        if (_size == 0) return;
+        _os.write(_buffer.data(), static_cast<std::streamsize>(_size));
+        _size = 0;
+        if (!_os) throw std::runtime_error("Failed to write report");
+    }
+
+private:
+    void write_text(const Figure<T>& figure) {
+        put("Figure ");
+        integer(_index);
+        put(":\nFigure with ");
+        integer(figure.get_points_count());
+        put(" points:\n");
+        for (size_t i = 0; i < figure.get_points_count(); ++i) {
+            const Point<T>& p = figure.get_point(i);
+            put("Point ");
+            integer(i);
+            put(": (");
+            text_number(p.getX());
+            put(", ");
+            text_number(p.getY());
+            put(")\n");
+        }
+        put("Area: ");
+        text_number(figure.area());
+        const Point<T> center = figure.center();
+        put("\nCenter: (");
+        text_number(center.getX());
+        put(", ");
+        text_number(center.getY());
+        put(")\n\n");
+    }
+
+    void write_csv(const Figure<T>& figure) {
+        integer(_index);
+        put(',');
+        put(report_detail::kind_name(figure.kind()));
+        put(',');
+        exact_number(figure.area());
+        const Point<T> center = figure.center();
+        put(',');
+        exact_number(center.getX());
+        put(',');
+        exact_number(center.getY());
+        put(',');
+        for (size_t i = 0; i < figure.get_points_count(); ++i) {
+            const Point<T>& p = figure.get_point(i);
+            if (i > 0) put(' ');
+            exact_number(p.getX());
+            put(' ');
+            exact_number(p.getY());
+        }
+        put('\n');
+    }
+
+    void write_json(const Figure<T>& figure) {
+        put("{\"index\":");
+        integer(_index);
+        put(",\"kind\":\"");
+        put(report_detail::kind_name(figure.kind()));
+        put("\",\"area\":");
+        json_number(figure.area());
+        const Point<T> center = figure.center();
+        put(",\"center\":[");
+        json_number(center.getX());
+        put(',');
+        json_number(center.getY());
+        put("],\"points\":[");
+        for (size_t i = 0; i < figure.get_points_count(); ++i) {
+            const Point<T>& p = figure.get_point(i);
+            put(i > 0 ? ",[" : "[");
+            json_number(p.getX());
+            put(',');
+            json_number(p.getY());
+            put(']');
+        }
+        put("]}\n");
+    }
+
+    // Освобождает в буфере место под count символов
+    char* reserve(size_t count) {
+        if (_size + count > _buffer.size()) flush();
+        return _buffer.data() + _size;
+    }
+
+    void put(char c) {
+        *reserve(1) = c;
+        ++_size;
+    }
+
+    // Длинные строки выводятся частями по размеру буфера
+    void put(std::string_view text) {
+        while (!text.empty()) {
+            const size_t chunk = std::min(text.size(), _buffer.size());
+            std::memcpy(reserve(chunk), text.data(), chunk);
+            _size += chunk;
+            text.remove_prefix(chunk);
+        }
+    }
+
+    template<class... Format>
+    void convert(auto value, Format... format) {
+        char* first = reserve(report_detail::max_number_size);
+        auto [last, ec] = std::to_chars(first, first + report_detail::max_number_size, value, format...);
+        (void)ec;
+        _size += static_cast<size_t>(last - first);
+    }
+
+    void integer(size_t value) { convert(value); }
+
+    // Как std::ostream по умолчанию: целые без изменений, остальное — %g
+    template<class V>
+    void text_number(V value) {
+        if constexpr (std::integral<V>) convert(value);
+        else convert(value, std::chars_format::general, 6);
+    }
+
+    // Кратчайшая запись, из которой значение восстанавливается точно
+    template<class V>
+    void exact_number(V value) {
+        convert(value);
+    }
+
+    template<class V>
+    void json_number(V value) {
+        if constexpr (std::floating_point<V>) {
+            if (!std::isfinite(value)) {
+                put("null");
+                return;
+            }
+        }
+        convert(value);
+    }
+
+    std::ostream& _os;
+    ReportFormat _format;
+    Array<char> _buffer;
+    size_t _size = 0;
+    size_t _index = 0;
+};
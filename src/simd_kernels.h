@@ -0,0 +1,474 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Пакетные ядра для четырёхугольников (по 4 вершины подряд: xs[4 * i + v]).
+// Одна SIMD-линия — одна фигура, операции в каждой линии выполняются в том же
+// порядке, что и в скалярном коде Trapezoid::operator double() и center(),
+// поэтому результаты совпадают со скалярными бит в бит.
+// Реализация выбирается при запуске по возможностям процессора:
+// AVX-512F, AVX2, SSE2 или скалярный код.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FIGURES_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(FIGURES_SIMD_X86) && !defined(__clang__)
+// Слияние умножения и сложения в FMA изменило бы результат относительно скалярного кода
+#define FIGURES_SIMD_TARGET(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+#elif defined(FIGURES_SIMD_X86)
+#define FIGURES_SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace simd {
+
+enum class Level { Scalar, SSE2, AVX2, AVX512 };
+
+inline const char* level_name(Level level) {
+    switch (level) {
+        case Level::SSE2: return "SSE2";
+        case Level::AVX2: return "AVX2";
+        case Level::AVX512: return "AVX-512";
+        default: return "Scalar";
+    }
+}
+
+// Лучший набор инструкций, доступный на текущем процессоре
+inline Level detect_level() {
+#ifdef FIGURES_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Level::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Level::SSE2;
+#endif
+    return Level::Scalar;
+}
+
+inline Level active_level() {
+    static const Level level = detect_level();
+    return level;
+}
+
+template<class T>
+concept KernelCoordinate = std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// ==================== Скалярные версии ====================
+
+template<KernelCoordinate T>
+void quad_areas_scalar(const T* xs, const T* ys, size_t count, double* out) {
+    for (size_t f = 0; f < count; ++f) {
+        const T* x = xs + 4 * f;
+        const T* y = ys + 4 * f;
+        double sum = 0.0;
+        for (size_t i = 0; i < 4; ++i) {
+            size_t j = (i + 1) % 4;
+            sum += static_cast<double>(x[i]) * static_cast<double>(y[j])
+                 - static_cast<double>(x[j]) * static_cast<double>(y[i]);
+        }
+        out[f] = std::abs(sum) * 0.5;
+    }
+}
+
+template<KernelCoordinate T>
+void quad_centers_scalar(const T* xs, const T* ys, size_t count, T* cx, T* cy) {
+    const size_t vertices = 4;
+    for (size_t f = 0; f < count; ++f) {
+        T sum_x = 0, sum_y = 0;
+        for (size_t v = 0; v < vertices; ++v) {
+            sum_x += xs[4 * f + v];
+            sum_y += ys[4 * f + v];
+        }
+        // Деление на size_t, как в Figure::center()
+        cx[f] = static_cast<T>(sum_x / vertices);
+        cy[f] = static_cast<T>(sum_y / vertices);
+    }
+}
+
+#ifdef FIGURES_SIMD_X86
+
+// Вершины в памяти идут по фигурам, а в регистрах нужны по линиям:
+// блоки из четырёх фигур загружаются подряд и транспонируются 4x4,
+// после чего строка v содержит v-ю вершину каждой фигуры.
+
+// ==================== SSE2: 2 фигуры (double) / 4 фигуры (int, float) ====================
+
+template<KernelCoordinate T>
+FIGURES_SIMD_TARGET("sse2")
+inline __m128d load_sse2_pd(const T* base, size_t v) {
+    return _mm_set_pd(static_cast<double>(base[4 + v]), static_cast<double>(base[v]));
+}
+
+FIGURES_SIMD_TARGET("sse2")
+inline void transpose_sse2(__m128i (&rows)[4]) {
+    __m128i t0 = _mm_unpacklo_epi32(rows[0], rows[1]);
+    __m128i t1 = _mm_unpacklo_epi32(rows[2], rows[3]);
+    __m128i t2 = _mm_unpackhi_epi32(rows[0], rows[1]);
+    __m128i t3 = _mm_unpackhi_epi32(rows[2], rows[3]);
+    rows[0] = _mm_unpacklo_epi64(t0, t1);
+    rows[1] = _mm_unpackhi_epi64(t0, t1);
+    rows[2] = _mm_unpacklo_epi64(t2, t3);
+    rows[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+// 4 фигуры с 32-битными координатами
+template<class T>
+FIGURES_SIMD_TARGET("sse2")
+inline void load_quads_sse2(const T* base, __m128i (&rows)[4]) {
+    for (size_t r = 0; r < 4; ++r) {
+        rows[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + 4 * r));
+    }
+    transpose_sse2(rows);
+}
+
+template<KernelCoordinate T>
+FIGURES_SIMD_TARGET("sse2")
+void quad_areas_sse2(const T* xs, const T* ys, size_t count, double* out) {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d half = _mm_set1_pd(0.5);
+    size_t f = 0;
+    for (; f + 2 <= count; f += 2) {
+        __m128d x[4], y[4];
+        for (size_t v = 0; v < 4; ++v) {
+            x[v] = load_sse2_pd(xs + 4 * f, v);
+            y[v] = load_sse2_pd(ys + 4 * f, v);
+        }
+        __m128d sum = _mm_setzero_pd();
+        for (size_t i = 0; i < 4; ++i) {
+            size_t j = (i + 1) % 4;
+            sum = _mm_add_pd(sum, _mm_sub_pd(_mm_mul_pd(x[i], y[j]), _mm_mul_pd(x[j], y[i])));
+        }
+        _mm_storeu_pd(out + f, _mm_mul_pd(_mm_andnot_pd(sign, sum), half));
+    }
+    quad_areas_scalar(xs + 4 * f, ys + 4 * f, count - f, out + f);
+}
+
+template<KernelCoordinate T>
+FIGURES_SIMD_TARGET("sse2")
+void quad_centers_sse2(const T* xs, const T* ys, size_t count, T* cx, T* cy) {
+    size_t f = 0;
+    if constexpr (std::is_same_v<T, double>) {
+        const __m128d divisor = _mm_set1_pd(4.0);
+        for (; f + 2 <= count; f += 2) {
+            __m128d sx = _mm_setzero_pd(), sy = _mm_setzero_pd();
+            for (size_t v = 0; v < 4; ++v) {
+                sx = _mm_add_pd(sx, load_sse2_pd(xs + 4 * f, v));
+                sy = _mm_add_pd(sy, load_sse2_pd(ys + 4 * f, v));
+            }
+            _mm_storeu_pd(cx + f, _mm_div_pd(sx, divisor));
+            _mm_storeu_pd(cy + f, _mm_div_pd(sy, divisor));
+        }
+    } else {
+        for (; f + 4 <= count; f += 4) {
+            __m128i rx[4], ry[4];
+            load_quads_sse2(xs + 4 * f, rx);
+            load_quads_sse2(ys + 4 * f, ry);
+            if constexpr (std::is_same_v<T, float>) {
+                __m128 sx = _mm_setzero_ps(), sy = _mm_setzero_ps();
+                for (size_t v = 0; v < 4; ++v) {
+                    sx = _mm_add_ps(sx, _mm_castsi128_ps(rx[v]));
+                    sy = _mm_add_ps(sy, _mm_castsi128_ps(ry[v]));
+                }
+                const __m128 divisor = _mm_set1_ps(4.0f);
+                _mm_storeu_ps(cx + f, _mm_div_ps(sx, divisor));
+                _mm_storeu_ps(cy + f, _mm_div_ps(sy, divisor));
+            } else {
+                __m128i sx = _mm_setzero_si128(), sy = _mm_setzero_si128();
+                for (size_t v = 0; v < 4; ++v) {
+                    sx = _mm_add_epi32(sx, rx[v]);
+                    sy = _mm_add_epi32(sy, ry[v]);
+                }
+                // int / size_t в скалярном коде даёт деление с округлением вниз
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(cx + f), _mm_srai_epi32(sx, 2));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(cy + f), _mm_srai_epi32(sy, 2));
+            }
+        }
+    }
+    quad_centers_scalar(xs + 4 * f, ys + 4 * f, count - f, cx + f, cy + f);
+}
+
+// ==================== AVX2: 4 фигуры (double) / 8 фигур (int, float) ====================
+
+// 4 фигуры с координатами double
+FIGURES_SIMD_TARGET("avx2")
+inline void load_quads_avx2(const double* base, __m256d (&rows)[4]) {
+    __m256d r0 = _mm256_loadu_pd(base);
+    __m256d r1 = _mm256_loadu_pd(base + 4);
+    __m256d r2 = _mm256_loadu_pd(base + 8);
+    __m256d r3 = _mm256_loadu_pd(base + 12);
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+    __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+    __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+    rows[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+    rows[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+    rows[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+    rows[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+// 8 фигур с 32-битными координатами: фигуры k и k + 4 попадают в разные
+// половины регистра, и транспонирование внутри половин сохраняет порядок
+template<class T>
+FIGURES_SIMD_TARGET("avx2")
+inline void load_quads_avx2(const T* base, __m256i (&rows)[4]) {
+    for (size_t r = 0; r < 4; ++r) {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + 4 * r));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + 4 * (r + 4)));
+        rows[r] = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+    }
+    __m256i t0 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+    __m256i t1 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+    __m256i t2 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+    __m256i t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+    rows[0] = _mm256_unpacklo_epi64(t0, t1);
+    rows[1] = _mm256_unpackhi_epi64(t0, t1);
+    rows[2] = _mm256_unpacklo_epi64(t2, t3);
+    rows[3] = _mm256_unpackhi_epi64(t2, t3);
+}
+
+// v-я вершина четырёх фигур в линиях double
+template<KernelCoordinate T>
+FIGURES_SIMD_TARGET("avx2")
+inline void load_quads_avx2_pd(const T* base, __m256d (&rows)[4]) {
+    if constexpr (std::is_same_v<T, double>) {
+        load_quads_avx2(base, rows);
+    } else {
+        __m128i raw[4];
+        load_quads_sse2(base, raw);
+        for (size_t v = 0; v < 4; ++v) {
+            if constexpr (std::is_same_v<T, float>) rows[v] = _mm256_cvtps_pd(_mm_castsi128_ps(raw[v]));
+            else rows[v] = _mm256_cvtepi32_pd(raw[v]);
+        }
+    }
+}
+
+template<KernelCoordinate T>
+FIGURES_SIMD_TARGET("avx2")
+void quad_areas_avx2(const T* xs, const T* ys, size_t count, double* out) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    size_t f = 0;
+    for (; f + 4 <= count; f += 4) {
+        __m256d x[4], y[4];
+        load_quads_avx2_pd(xs + 4 * f, x);
+        load_quads_avx2_pd(ys + 4 * f, y);
+        __m256d sum = _mm256_setzero_pd();
+        for (size_t i = 0; i < 4; ++i) {
+            size_t j = (i + 1) % 4;
+            sum = _mm256_add_pd(sum, _mm256_sub_pd(_mm256_mul_pd(x[i], y[j]), _mm256_mul_pd(x[j], y[i])));
+        }
+        _mm256_storeu_pd(out + f, _mm256_mul_pd(_mm256_andnot_pd(sign, sum), half));
+    }
+    quad_areas_scalar(xs + 4 * f, ys + 4 * f, count - f, out + f);
+}
+
+template<KernelCoordinate T>
+FIGURES_SIMD_TARGET("avx2")
+void quad_centers_avx2(const T* xs, const T* ys, size_t count, T* cx, T* cy) {
+    size_t f = 0;
+    if constexpr (std::is_same_v<T, double>) {
+        const __m256d divisor = _mm256_set1_pd(4.0);
+        for (; f + 4 <= count; f += 4) {
+            __m256d rx[4], ry[4];
+            load_quads_avx2(xs + 4 * f, rx);
+            load_quads_avx2(ys + 4 * f, ry);
+            __m256d sx = _mm256_setzero_pd(), sy = _mm256_setzero_pd();
+            for (size_t v = 0; v < 4; ++v) {
+                sx = _mm256_add_pd(sx, rx[v]);
+                sy = _mm256_add_pd(sy, ry[v]);
+            }
+            _mm256_storeu_pd(cx + f, _mm256_div_pd(sx, divisor));
+            _mm256_storeu_pd(cy + f, _mm256_div_pd(sy, divisor));
+        }
+    } else {
+        for (; f + 8 <= count; f += 8) {
+            __m256i rx[4], ry[4];
+            load_quads_avx2(xs + 4 * f, rx);
+            load_quads_avx2(ys + 4 * f, ry);
+            if constexpr (std::is_same_v<T, float>) {
+                __m256 sx = _mm256_setzero_ps(), sy = _mm256_setzero_ps();
+                for (size_t v = 0; v < 4; ++v) {
+                    sx = _mm256_add_ps(sx, _mm256_castsi256_ps(rx[v]));
+                    sy = _mm256_add_ps(sy, _mm256_castsi256_ps(ry[v]));
+                }
+                const __m256 divisor = _mm256_set1_ps(4.0f);
+                _mm256_storeu_ps(cx + f, _mm256_div_ps(sx, divisor));
+                _mm256_storeu_ps(cy + f, _mm256_div_ps(sy, divisor));
+            } else {
+                __m256i sx = _mm256_setzero_si256(), sy = _mm256_setzero_si256();
+                for (size_t v = 0; v < 4; ++v) {
+                    sx = _mm256_add_epi32(sx, rx[v]);
+                    sy = _mm256_add_epi32(sy, ry[v]);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(cx + f), _mm256_srai_epi32(sx, 2));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(cy + f), _mm256_srai_epi32(sy, 2));
+            }
+        }
+    }
+    quad_centers_scalar(xs + 4 * f, ys + 4 * f, count - f, cx + f, cy + f);
+}
+
+// ==================== AVX-512: 8 фигур (double) / 16 фигур (int, float) ====================
+
+// Формы с обнулением (maskz) и полной маской выполняют ту же операцию, что и
+// немаскированные, но без _mm512_undefined_*() в качестве источника: на него
+// GCC 12 ложно выдаёт -Wmaybe-uninitialized
+inline constexpr __mmask8 all_lanes_pd = 0xFF;
+inline constexpr __mmask16 all_lanes_epi32 = 0xFFFF;
+
+// v-я вершина восьми фигур в линиях double
+template<KernelCoordinate T>
+FIGURES_SIMD_TARGET("avx512f")
+inline void load_quads_avx512_pd(const T* base, __m512d (&rows)[4]) {
+    if constexpr (std::is_same_v<T, double>) {
+        __m256d low[4], high[4];
+        load_quads_avx2(base, low);
+        load_quads_avx2(base + 16, high);
+        for (size_t v = 0; v < 4; ++v) {
+            rows[v] = _mm512_maskz_insertf64x4(all_lanes_pd, _mm512_castpd256_pd512(low[v]), high[v], 1);
+        }
+    } else {
+        __m256i raw[4];
+        load_quads_avx2(base, raw);
+        for (size_t v = 0; v < 4; ++v) {
+            if constexpr (std::is_same_v<T, float>) {
+                rows[v] = _mm512_maskz_cvtps_pd(all_lanes_pd, _mm256_castsi256_ps(raw[v]));
+            } else {
+                rows[v] = _mm512_maskz_cvtepi32_pd(all_lanes_pd, raw[v]);
+            }
+        }
+    }
+}
+
+// 16 фигур с 32-битными координатами: четверть регистра k содержит фигуры
+// k, k + 4, k + 8, k + 12 до транспонирования
+template<class T>
+FIGURES_SIMD_TARGET("avx512f")
+inline void load_quads_avx512(const T* base, __m512i (&rows)[4]) {
+    for (size_t r = 0; r < 4; ++r) {
+        __m512i row = _mm512_castsi128_si512(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base + 4 * r)));
+        row = _mm512_inserti32x4(row, _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + 4 * (r + 4))), 1);
+        row = _mm512_inserti32x4(row, _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + 4 * (r + 8))), 2);
+        row = _mm512_inserti32x4(row, _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + 4 * (r + 12))), 3);
+        rows[r] = row;
+    }
+    __m512i t0 = _mm512_maskz_unpacklo_epi32(all_lanes_epi32, rows[0], rows[1]);
+    __m512i t1 = _mm512_maskz_unpacklo_epi32(all_lanes_epi32, rows[2], rows[3]);
+    __m512i t2 = _mm512_maskz_unpackhi_epi32(all_lanes_epi32, rows[0], rows[1]);
+    __m512i t3 = _mm512_maskz_unpackhi_epi32(all_lanes_epi32, rows[2], rows[3]);
+    rows[0] = _mm512_maskz_unpacklo_epi64(all_lanes_pd, t0, t1);
+    rows[1] = _mm512_maskz_unpackhi_epi64(all_lanes_pd, t0, t1);
+    rows[2] = _mm512_maskz_unpacklo_epi64(all_lanes_pd, t2, t3);
+    rows[3] = _mm512_maskz_unpackhi_epi64(all_lanes_pd, t2, t3);
+}
+
+template<KernelCoordinate T>
+FIGURES_SIMD_TARGET("avx512f")
+void quad_areas_avx512(const T* xs, const T* ys, size_t count, double* out) {
+    const __m512d half = _mm512_set1_pd(0.5);
+    size_t f = 0;
+    for (; f + 8 <= count; f += 8) {
+        __m512d x[4], y[4];
+        load_quads_avx512_pd(xs + 4 * f, x);
+        load_quads_avx512_pd(ys + 4 * f, y);
+        __m512d sum = _mm512_setzero_pd();
+        for (size_t i = 0; i < 4; ++i) {
+            size_t j = (i + 1) % 4;
+            sum = _mm512_add_pd(sum, _mm512_sub_pd(_mm512_mul_pd(x[i], y[j]), _mm512_mul_pd(x[j], y[i])));
+        }
+        _mm512_storeu_pd(out + f, _mm512_mul_pd(_mm512_abs_pd(sum), half));
+    }
+    quad_areas_scalar(xs + 4 * f, ys + 4 * f, count - f, out + f);
+}
+
+template<KernelCoordinate T>
+FIGURES_SIMD_TARGET("avx512f")
+void quad_centers_avx512(const T* xs, const T* ys, size_t count, T* cx, T* cy) {
+    size_t f = 0;
+    if constexpr (std::is_same_v<T, double>) {
+        const __m512d divisor = _mm512_set1_pd(4.0);
+        for (; f + 8 <= count; f += 8) {
+            __m512d rx[4], ry[4];
+            load_quads_avx512_pd(xs + 4 * f, rx);
+            load_quads_avx512_pd(ys + 4 * f, ry);
+            __m512d sx = _mm512_setzero_pd(), sy = _mm512_setzero_pd();
+            for (size_t v = 0; v < 4; ++v) {
+                sx = _mm512_add_pd(sx, rx[v]);
+                sy = _mm512_add_pd(sy, ry[v]);
+            }
+            _mm512_storeu_pd(cx + f, _mm512_div_pd(sx, divisor));
+            _mm512_storeu_pd(cy + f, _mm512_div_pd(sy, divisor));
+        }
+    } else {
+        for (; f + 16 <= count; f += 16) {
+            __m512i rx[4], ry[4];
+            load_quads_avx512(xs + 4 * f, rx);
+            load_quads_avx512(ys + 4 * f, ry);
+            if constexpr (std::is_same_v<T, float>) {
+                __m512 sx = _mm512_setzero_ps(), sy = _mm512_setzero_ps();
+                for (size_t v = 0; v < 4; ++v) {
+                    sx = _mm512_add_ps(sx, _mm512_castsi512_ps(rx[v]));
+                    sy = _mm512_add_ps(sy, _mm512_castsi512_ps(ry[v]));
+                }
+                const __m512 divisor = _mm512_set1_ps(4.0f);
+                _mm512_storeu_ps(cx + f, _mm512_div_ps(sx, divisor));
+                _mm512_storeu_ps(cy + f, _mm512_div_ps(sy, divisor));
+            } else {
+                __m512i sx = _mm512_setzero_si512(), sy = _mm512_setzero_si512();
+                for (size_t v = 0; v < 4; ++v) {
+                    sx = _mm512_add_epi32(sx, rx[v]);
+                    sy = _mm512_add_epi32(sy, ry[v]);
+                }
+                _mm512_storeu_si512(cx + f, _mm512_maskz_srai_epi32(all_lanes_epi32, sx, 2));
+                _mm512_storeu_si512(cy + f, _mm512_maskz_srai_epi32(all_lanes_epi32, sy, 2));
+            }
+        }
+    }
+    quad_centers_scalar(xs + 4 * f, ys + 4 * f, count - f, cx + f, cy + f);
+}
+
+#endif // FIGURES_SIMD_X86
+
+// Уровень выше доступного понижается до поддерживаемого процессором
+inline Level clamp_level(Level requested) {
+    Level available = active_level();
+    return static_cast<int>(requested) > static_cast<int>(available) ? available : requested;
+}
+
+// ==================== Диспетчеризация ====================
+
+// Площади count четырёхугольников по формуле Гаусса
+template<KernelCoordinate T>
+void quad_areas(const T* xs, const T* ys, size_t count, double* out, Level level = active_level()) {
+#ifdef FIGURES_SIMD_X86
+    switch (clamp_level(level)) {
+        case Level::AVX512: return quad_areas_avx512(xs, ys, count, out);
+        case Level::AVX2: return quad_areas_avx2(xs, ys, count, out);
+        case Level::SSE2: return quad_areas_sse2(xs, ys, count, out);
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    quad_areas_scalar(xs, ys, count, out);
+}
+
+// Центры count четырёхугольников как среднее арифметическое вершин
+template<KernelCoordinate T>
+void quad_centers(const T* xs, const T* ys, size_t count, T* cx, T* cy, Level level = active_level()) {
+#ifdef FIGURES_SIMD_X86
+    switch (clamp_level(level)) {
+        case Level::AVX512: return quad_centers_avx512(xs, ys, count, cx, cy);
+        case Level::AVX2: return quad_centers_avx2(xs, ys, count, cx, cy);
+        case Level::SSE2: return quad_centers_sse2(xs, ys, count, cx, cy);
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    quad_centers_scalar(xs, ys, count, cx, cy);
+}
+
+} // namespace simd
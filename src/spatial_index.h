@@ -0,0 +1,237 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include "array.h"
+#include "figure.h"
+
+// Пространственный индекс по габаритам фигур: упакованное R-дерево,
+// построенное методом STR (Sort-Tile-Recursive) за O(n log n).
+// Уровень 0 — габариты фигур в порядке STR, каждый следующий уровень —
+// объединения групп по node_capacity узлов, дочерние узлы лежат подряд.
+//
+// Вставленные после построения фигуры попадают в буфер, который
+// просматривается линейно; когда буфер вырастает до четверти дерева,
+// индекс перестраивается (амортизированно O(log n) на вставку).
+// Идентификатор фигуры — её порядковый номер при добавлении. Изменения
+// фигур после добавления индекс не отслеживает: нужен rebuild().
+template<class T>
+class SpatialIndex {
+public:
+    using P = Point<T>;
+    using Box = BoundingBox<T>;
+    using FigurePtr = std::shared_ptr<Figure<T>>;
+
+    static constexpr size_t node_capacity = 16;
+    static constexpr size_t min_pending = 256;
+
+    SpatialIndex() = default;
+
+    explicit SpatialIndex(const Array<FigurePtr>& figures) {
+        _figures.reserve(figures.size());
+        _boxes.reserve(figures.size());
+        _centers.reserve(figures.size());
+        for (const auto& figure : figures) {
+            add(figure);
+        }
+        rebuild();
+    }
+
+    void insert(FigurePtr figure) {
+        add(std::move(figure));
+        _pending.push_back(_figures.size() - 1);
+        if (_pending.size() > std::max(min_pending, _order.size() / 4)) rebuild();
+    }
+
+    // Заново строит дерево по всем фигурам (в том числе из буфера)
+    void rebuild() {
+        const size_t n = _figures.size();
+        _order.resize(n);
+        std::iota(_order.begin(), _order.end(), size_t(0));
+        _pending.clear();
+        _levels.clear();
+        if (n == 0) return;
+
+        auto center_x = [&](size_t id) { return mid(_boxes.unchecked(id).min.getX(), _boxes.unchecked(id).max.getX()); };
+        auto center_y = [&](size_t id) { return mid(_boxes.unchecked(id).min.getY(), _boxes.unchecked(id).max.getY()); };
+
+        // STR: вертикальные полосы по x, внутри полосы — по y
+        std::sort(_order.begin(), _order.end(), [&](size_t a, size_t b) { return center_x(a) < center_x(b); });
+        const size_t leaves = (n + node_capacity - 1) / node_capacity;
+        const size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(leaves))));
+        const size_t slice_size = slices * node_capacity;
+        for (size_t begin = 0; begin < n; begin += slice_size) {
+            const size_t end = std::min(n, begin + slice_size);
+            std::sort(_order.begin() + begin, _order.begin() + end,
+                      [&](size_t a, size_t b) { return center_y(a) < center_y(b); });
+        }
+
+        Array<Box> level;
+        level.reserve(n);
+        for (size_t id : _order) {
+            level.push_back(_boxes.unchecked(id));
+        }
+        _levels.push_back(std::move(level));
+        while (_levels[_levels.size() - 1].size() > 1) {
+            const Array<Box>& children = _levels[_levels.size() - 1];
+            Array<Box> parents;
+            parents.reserve((children.size() + node_capacity - 1) / node_capacity);
+            for (size_t begin = 0; begin < children.size(); begin += node_capacity) {
+                const size_t end = std::min(children.size(), begin + node_capacity);
+                Box box = children.unchecked(begin);
+                for (size_t i = begin + 1; i < end; ++i) {
+                    box = merge(box, children.unchecked(i));
+                }
+                parents.push_back(box);
+            }
+            _levels.push_back(std::move(parents));
+        }
+    }
+
+    size_t size() const noexcept { return _figures.size(); }
+    bool empty() const noexcept { return _figures.empty(); }
+    size_t pending() const noexcept { return _pending.size(); }
+
+    const FigurePtr& operator[](size_t id) const { return _figures[id]; }
+    const Box& bounding_box(size_t id) const { return _boxes[id]; }
+
+    // Вызывает func(id) для каждой фигуры, чей габарит пересекает window
+    // (границы включаются)
+    template<class Func>
+    void for_each_in(const Box& window, Func&& func) const {
+        if (!_levels.empty()) {
+            // Глубина дерева не больше 16, в стеке не больше depth * node_capacity узлов
+            struct Frame { size_t level; size_t index; };
+            Frame stack[16 * node_capacity];
+            size_t top = 0;
+            stack[top++] = {_levels.size() - 1, 0};
+            while (top > 0) {
+                const Frame frame = stack[--top];
+                if (!intersects(_levels.unchecked(frame.level).unchecked(frame.index), window)) continue;
+                if (frame.level == 0) {
+                    func(_order.unchecked(frame.index));
+                    continue;
+                }
+                const size_t begin = frame.index * node_capacity;
+                const size_t end = std::min(_levels.unchecked(frame.level - 1).size(), begin + node_capacity);
+                for (size_t child = end; child-- > begin;) {
+                    stack[top++] = {frame.level - 1, child};
+                }
+            }
+        }
+        for (size_t id : _pending) {
+            if (intersects(_boxes.unchecked(id), window)) func(id);
+        }
+    }
+
+    Array<size_t> query(const Box& window) const {
+        Array<size_t> result;
+        for_each_in(window, [&](size_t id) { result.push_back(id); });
+        return result;
+    }
+
+    // k фигур с ближайшими к point центрами, по возрастанию расстояния.
+    // Поиск «лучший первым»: расстояние до габарита узла — нижняя граница
+    // расстояния до центров фигур внутри него
+    Array<size_t> nearest(const P& point, size_t k) const {
+        Array<size_t> result;
+        if (k == 0 || empty()) return result;
+        result.reserve(std::min(k, size()));
+
+        Array<Candidate> heap;
+        auto push = [&](Candidate candidate) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end(), std::greater<>());
+        };
+        if (!_levels.empty()) {
+            const size_t top = _levels.size() - 1;
+            push({min_distance(_levels[top][0], point), top, 0, false});
+        }
+        for (size_t id : _pending) {
+            push({center_distance(id, point), 0, id, true});
+        }
+
+        while (!heap.empty() && result.size() < k) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+            const Candidate candidate = heap[heap.size() - 1];
+            heap.pop_back();
+            if (candidate.exact) {
+                result.push_back(candidate.index);
+            } else if (candidate.level == 0) {
+                const size_t id = _order.unchecked(candidate.index);
+                push({center_distance(id, point), 0, id, true});
+            } else {
+                const size_t begin = candidate.index * node_capacity;
+                const size_t end = std::min(_levels.unchecked(candidate.level - 1).size(), begin + node_capacity);
+                for (size_t child = begin; child < end; ++child) {
+                    const Box& box = _levels.unchecked(candidate.level - 1).unchecked(child);
+                    push({min_distance(box, point), candidate.level - 1, child, false});
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    // Узел или фигура в очереди поиска ближайших; exact — точное расстояние
+    // до центра фигуры index, иначе — нижняя граница для узла (level, index)
+    struct Candidate {
+        double distance;
+        size_t level;
+        size_t index;
+        bool exact;
+
+        bool operator>(const Candidate& other) const noexcept {
+            if (distance != other.distance) return distance > other.distance;
+            // При равных расстояниях точные кандидаты выходят раньше, затем по номеру
+            if (exact != other.exact) return !exact;
+            return index > other.index;
+        }
+    };
+
+    void add(FigurePtr figure) {
+        if (!figure) throw std::invalid_argument("Null figure");
+        _boxes.push_back(figure->bounding_box());
+        _centers.push_back(figure->center());
+        _figures.push_back(std::move(figure));
+    }
+
+    static double mid(T a, T b) { return (static_cast<double>(a) + static_cast<double>(b)) * 0.5; }
+
+    static Box merge(const Box& a, const Box& b) {
+        return {P(std::min(a.min.getX(), b.min.getX()), std::min(a.min.getY(), b.min.getY())),
+                P(std::max(a.max.getX(), b.max.getX()), std::max(a.max.getY(), b.max.getY()))};
+    }
+
+    static bool intersects(const Box& a, const Box& b) {
+        return a.min.getX() <= b.max.getX() && b.min.getX() <= a.max.getX()
+            && a.min.getY() <= b.max.getY() && b.min.getY() <= a.max.getY();
+    }
+
+    // Квадрат расстояния от точки до прямоугольника (0, если точка внутри)
+    static double min_distance(const Box& box, const P& point) {
+        const double x = static_cast<double>(point.getX());
+        const double y = static_cast<double>(point.getY());
+        const double dx = std::max({static_cast<double>(box.min.getX()) - x, 0.0, x - static_cast<double>(box.max.getX())});
+        const double dy = std::max({static_cast<double>(box.min.getY()) - y, 0.0, y - static_cast<double>(box.max.getY())});
+        return dx * dx + dy * dy;
+    }
+
+    double center_distance(size_t id, const P& point) const {
+        const double dx = static_cast<double>(_centers.unchecked(id).getX()) - static_cast<double>(point.getX());
+        const double dy = static_cast<double>(_centers.unchecked(id).getY()) - static_cast<double>(point.getY());
+        return dx * dx + dy * dy;
+    }
+
+    Array<FigurePtr> _figures;
+    Array<Box> _boxes;
+    Array<P> _centers;
+    Array<size_t> _order;
+    Array<Array<Box>> _levels;
+    Array<size_t> _pending;
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "array.h"
+
+// Статистика очереди, которую ведёт производитель: заполненность
+// замеряется сразу после каждого push
+struct QueueStats {
+    size_t capacity = 0;
+    size_t pushes = 0;
+    double average_occupancy = 0;
+    size_t max_occupancy = 0;
+};
+
+// Ограниченная кольцевая очередь с одним производителем и одним
+// потребителем. push и pop не берут блокировок: производитель пишет только
+// _tail, потребитель — только _head. На полной или пустой очереди поток
+// ждёт через std::atomic::wait на счётчике событий, который увеличивают
+// push, pop и close.
+//
+// close() может вызвать любая сторона: производитель — когда данных больше
+// не будет, потребитель — чтобы остановить производителя. После close()
+// push возвращает false, а pop отдаёт оставшиеся элементы и затем
+// возвращает false.
+template<class T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        _slots.resize(std::max<size_t>(capacity, 1));
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const noexcept { return _slots.size(); }
+
+    // Ждёт свободного места; false — очередь закрыта, value не принято
+    bool push(T value) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        for (;;) {
+            const std::uint32_t seen = _events.load(std::memory_order_acquire);
+            if (_closed.load(std::memory_order_acquire)) return false;
+            const size_t occupied = tail - _head.load(std::memory_order_acquire);
+            if (occupied < _slots.size()) {
+                _slots.unchecked(tail % _slots.size()) = std::move(value);
+                _tail.store(tail + 1, std::memory_order_release);
+                signal();
+                ++_pushes;
+                _occupancy_sum += occupied + 1;
+                _max_occupancy = std::max(_max_occupancy, occupied + 1);
+                return true;
+            }
+            _events.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    // Ждёт элемента; false — очередь закрыта и пуста
+    bool pop(T& value) {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            const std::uint32_t seen = _events.load(std::memory_order_acquire);
+            if (_tail.load(std::memory_order_acquire) != head) {
+                value = std::move(_slots.unchecked(head % _slots.size()));
+                _head.store(head + 1, std::memory_order_release);
+                signal();
+                return true;
+            }
+            // Всё, что записано до close(), видно после него: проверка повторяется
+            if (_closed.load(std::memory_order_acquire)) {
+                if (_tail.load(std::memory_order_acquire) == head) return false;
+                continue;
+            }
+            _events.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    void close() noexcept {
+        _closed.store(true, std::memory_order_release);
+        signal();
+    }
+
+    // Читается после того, как производитель закончил работу
+    QueueStats stats() const noexcept {
+        QueueStats stats;
+        stats.capacity = _slots.size();
+        stats.pushes = _pushes;
+        stats.average_occupancy = _pushes ? static_cast<double>(_occupancy_sum) / static_cast<double>(_pushes) : 0.0;
+        stats.max_occupancy = _max_occupancy;
+        return stats;
+    }
+
+private:
+    void signal() noexcept {
+        _events.fetch_add(1, std::memory_order_release);
+        _events.notify_all();
+    }
+
+    Array<T> _slots;
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<size_t> _tail{0};
+    alignas(64) std::atomic<std::uint32_t> _events{0};
+    std::atomic<bool> _closed{false};
+    // Только для производителя
+    size_t _pushes = 0;
+    size_t _occupancy_sum = 0;
+    size_t _max_occupancy = 0;
+};
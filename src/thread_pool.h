@@ -0,0 +1,209 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "array.h"
+
+// Пул потоков с перехватом задач (work stealing): у каждого потока своя
+// очередь, свои задачи он берёт с конца, а простаивая — забирает задачи
+// из начала чужих очередей. Поток, ожидающий parallel_for, тоже выполняет задачи.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // Размер блока по умолчанию; от количества потоков не зависит
+    static constexpr size_t default_grain = 4096;
+
+    // threads == 0 — по числу аппаратных потоков
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        _queues.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) _queues.push_back(std::make_unique<Queue>());
+        _workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            _workers.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& worker : _workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const noexcept { return _workers.size(); }
+
+    // Исключение, вышедшее из задачи, завершает программу (std::terminate)
+    void submit(Task task) {
+        size_t index = (_current_pool == this) ? _current_index
+                                               : _next_queue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+        // Счётчик растёт раньше, чем задача становится видна: он не уходит в минус
+        _pending.fetch_add(1, std::memory_order_release);
+        try {
+            std::lock_guard<std::mutex> lock(_queues.unchecked(index)->mutex);
+            _queues.unchecked(index)->tasks.push_back(std::move(task));
+        } catch (...) {
+            // Задача не попала в очередь — возвращаем счётчик
+            _pending.fetch_sub(1, std::memory_order_acq_rel);
+            throw;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+        }
+        _wake.notify_one();
+    }
+
+    // Вызывает body(begin, end) для блоков [0, count) по grain элементов
+    // и ждёт их завершения. Границы блоков зависят только от count и grain.
+    // Первое исключение из body пробрасывается вызывающему. Если
+    // поставить блок не удалось, уже поставленные доводятся до конца.
+    template<class Body>
+    void parallel_for(size_t count, size_t grain, Body&& body) {
+        if (count == 0) return;
+        grain = std::max<size_t>(1, grain);
+        const size_t chunks = (count + grain - 1) / grain;
+        if (chunks == 1) {
+            body(size_t(0), count);
+            return;
+        }
+
+        std::atomic<size_t> remaining(chunks);
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        auto wait = [&] {
+            while (remaining.load(std::memory_order_acquire) > 0) {
+                if (run_one()) continue;
+                // Красть нечего: оставшиеся блоки уже выполняются другими
+                // потоками — ждём их завершения, не занимая ядро
+                std::unique_lock<std::mutex> lock(_done_mutex);
+                _done.wait(lock, [&] { return remaining.load(std::memory_order_acquire) == 0; });
+            }
+        };
+        size_t submitted = 0;
+        try {
+            for (; submitted < chunks; ++submitted) {
+                const size_t c = submitted;
+                submit([&, c] {
+                    try {
+                        body(c * grain, std::min(count, (c + 1) * grain));
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (!error) error = std::current_exception();
+                    }
+                    // Под мьютексом: ожидающий не пропустит уведомление и не
+                    // уничтожит remaining раньше, чем блок отпустит мьютекс
+                    {
+                        std::lock_guard<std::mutex> lock(_done_mutex);
+                        remaining.fetch_sub(1, std::memory_order_acq_rel);
+                    }
+                    _done.notify_all();
+                });
+            }
+        } catch (...) {
+            // Поставленные блоки ссылаются на этот кадр стека: дожидаемся их
+            // и только затем пробрасываем исключение (например, bad_alloc)
+            remaining.fetch_sub(chunks - submitted, std::memory_order_acq_rel);
+            wait();
+            throw;
+        }
+        wait();
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool take(size_t index, bool from_back, Task& task) {
+        Queue& queue = *_queues.unchecked(index);
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        if (from_back) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+
+    // Выполняет одну задачу: сначала свою, затем украденную
+    bool run_one() {
+        Task task;
+        const bool own = _current_pool == this;
+        const size_t start = own ? _current_index : 0;
+        bool found = own && take(start, true, task);
+        for (size_t i = 1; !found && i <= _queues.size(); ++i) {
+            found = take((start + i) % _queues.size(), false, task);
+        }
+        if (!found) return false;
+        _pending.fetch_sub(1, std::memory_order_acq_rel);
+        task();
+        return true;
+    }
+
+    void worker_loop(size_t index) {
+        _current_pool = this;
+        _current_index = index;
+        while (true) {
+            if (run_one()) continue;
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            _wake.wait(lock, [this] { return _stop || _pending.load(std::memory_order_acquire) > 0; });
+            if (_stop && _pending.load(std::memory_order_acquire) == 0) return;
+        }
+    }
+
+    Array<std::unique_ptr<Queue>> _queues;
+    Array<std::thread> _workers;
+    std::atomic<size_t> _pending{0};
+    std::atomic<size_t> _next_queue{0};
+    std::mutex _sleep_mutex;
+    std::condition_variable _wake;
+    // Завершение блоков parallel_for: будит вызывающих, которым нечего красть
+    std::mutex _done_mutex;
+    std::condition_variable _done;
+    bool _stop = false;
+
+    inline static thread_local ThreadPool* _current_pool = nullptr;
+    inline static thread_local size_t _current_index = 0;
+};
+
+// Детерминированная свёртка: элементы делятся на блоки по grain, каждый блок
+// сворачивается слева направо, затем частичные результаты объединяются по
+// порядку блоков. Результат не зависит от числа потоков и от запуска к запуску.
+template<class T, class R, class Map, class Reduce>
+R parallel_reduce(ThreadPool& pool, const Array<T>& items, R init, Map map, Reduce reduce,
+                  size_t grain = ThreadPool::default_grain) {
+    grain = std::max<size_t>(1, grain);
+    const size_t chunks = (items.size() + grain - 1) / grain;
+    Array<std::optional<R>> partials;
+    partials.resize(chunks);
+    pool.parallel_for(items.size(), grain, [&](size_t begin, size_t end) {
+        R partial = map(items.unchecked(begin));
+        for (size_t i = begin + 1; i < end; ++i) {
+            partial = reduce(std::move(partial), map(items.unchecked(i)));
+        }
+        partials.unchecked(begin / grain).emplace(std::move(partial));
+    });
+    for (auto& partial : partials) {
+        init = reduce(std::move(init), std::move(*partial));
+    }
+    return init;
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include "../src/thread_pool.h"
+
+// Отдельный исполняемый файл: глобальный operator new заменяется здесь
+// для всей программы, и основной набор тестов этой замены не видит
+
+// Отказ по счётчику: fail_allocation_after > 0 отсчитывает успешные
+// выделения текущего потока, на нуле бросается bad_alloc
+namespace {
+thread_local int fail_allocation_after = -1;
+}
+
+void* operator new(size_t size) {
+    if (fail_allocation_after > 0 && --fail_allocation_after == 0) {
+        fail_allocation_after = -1;
+        throw std::bad_alloc();
+    }
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+    throw std::bad_alloc();
+}
+
+// Остальные невыровненные формы заменяются тоже, чтобы выделение и
+// освобождение всегда шли одной парой (иначе ASan видит несовпадение)
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+// После встраивания GCC видит free() для памяти из operator new и
+// ложно предупреждает о несовпадении пары выделения и освобождения
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// ==================== ТЕСТЫ ДЛЯ THREAD POOL ====================
+
+TEST(ThreadPoolTest, FailedSubmitDrainsQueuedChunks) {
+    ThreadPool pool(2);
+    std::atomic<int> started{0}, finished{0};
+    auto body = [&](size_t, size_t) {
+        ++started;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        ++finished;
+    };
+    // Падает одно из первых выделений под задачи: часть блоков уже в очереди
+    fail_allocation_after = 3;
+    EXPECT_THROW(pool.parallel_for(100, 10, body), std::bad_alloc);
+    fail_allocation_after = -1;
+    EXPECT_GT(started.load(), 0);
+    EXPECT_LT(started.load(), 10);
+    const int done = finished.load();
+    EXPECT_EQ(done, started.load());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(started.load(), done);
+
+    // Пул остаётся рабочим
+    std::atomic<int> total{0};
+    pool.parallel_for(100, 10, [&](size_t begin, size_t end) { total += static_cast<int>(end - begin); });
+    EXPECT_EQ(total.load(), 100);
+}
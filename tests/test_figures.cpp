@@ -2,11 +2,41 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <sstream>
+#include <chrono>
 #include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "../src/point.h"
 #include "../src/array.h"
 #include "../src/figure.h"
 #include "../src/figures.h"
+#include "../src/figure_algorithms.h"
+#include "../src/figure_store.h"
+#include "../src/simd_kernels.h"
+#include "../src/figure_variant.h"
+#include "../src/thread_pool.h"
+#include "../src/figure_loader.h"
+#include "../src/figure_file.h"
+#include "../src/figure_arena.h"
+#include "../src/figure_tracker.h"
+#include "../src/instrumentation.h"
+#include "../src/fixed_polygon.h"
+#include "../src/spatial_index.h"
+#include "../src/figure_sort.h"
+#include "../src/report_writer.h"
+#include "../src/concurrent_array.h"
+#include "../src/spsc_ring.h"
+#include "../src/figure_pipeline.h"
+#include "../src/figure_collection.h"
+#include "../src/convex_hull.h"
+#include "../src/affine_transform.h"
 
 // ==================== ТЕСТЫ ДЛЯ POINT ====================
 
@@ -148,6 +178,167 @@ TEST(ArrayTest, Resize) {
     EXPECT_EQ(arr.size(), 1);
 }
 
+namespace {
+struct NoDefault {
+    explicit NoDefault(int v) : value(v) {}
+    int value;
+};
+
+// Копирование бросает на заданном номере, перемещения нет
+struct ThrowingCopy {
+    static inline int copies_left = 0;
+    explicit ThrowingCopy(int v) : value(v) {}
+    ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+        if (copies_left-- == 0) throw std::runtime_error("copy failed");
+    }
+    int value;
+};
+}
+
+TEST(ArrayTest, EmplaceBackWithoutDefaultConstructor) {
+    Array<NoDefault> arr;
+    arr.emplace_back(7);
+    arr.emplace_back(8);
+    EXPECT_EQ(arr.size(), 2);
+    EXPECT_EQ(arr[0].value, 7);
+    EXPECT_EQ(arr[1].value, 8);
+}
+
+TEST(ArrayTest, PopBackAndClearReleaseElements) {
+    auto shared = std::make_shared<int>(42);
+    Array<std::shared_ptr<int>> arr;
+    arr.push_back(shared);
+    arr.push_back(shared);
+    EXPECT_EQ(shared.use_count(), 3);
+    arr.pop_back();
+    EXPECT_EQ(shared.use_count(), 2);
+    arr.clear();
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(ArrayTest, ReserveDoesNotConstructSpareSlots) {
+    Array<std::shared_ptr<int>> arr;
+    arr.reserve(1000);
+    EXPECT_EQ(arr.size(), 0);
+    EXPECT_GE(arr.capacity(), 1000);
+}
+
+TEST(ArrayTest, GrowthIsStronglyExceptionSafe) {
+    Array<ThrowingCopy> arr;
+    ThrowingCopy::copies_left = 100;
+    arr.emplace_back(1);
+    arr.emplace_back(2);
+    ThrowingCopy::copies_left = 1;  // второе копирование при переносе бросит
+    EXPECT_THROW(arr.emplace_back(3), std::runtime_error);
+    EXPECT_EQ(arr.size(), 2);
+    EXPECT_EQ(arr.capacity(), 2);
+    EXPECT_EQ(arr[0].value, 1);
+    EXPECT_EQ(arr[1].value, 2);
+}
+
+TEST(ArrayTest, EmplaceBackFromOwnElement) {
+    Array<std::string> arr;
+    arr.push_back("first");
+    arr.push_back(arr[0]);
+    arr.push_back(arr[1]);
+    EXPECT_EQ(arr.size(), 3);
+    EXPECT_EQ(arr[2], "first");
+}
+
+TEST(ArrayTest, ContiguousRangeAndIterators) {
+    static_assert(std::ranges::contiguous_range<Array<int>>);
+    static_assert(std::ranges::sized_range<const Array<int>>);
+    Array<int> arr;
+    for (int i = 1; i <= 5; ++i) arr.push_back(i);
+    int sum = 0;
+    for (int value : arr) sum += value;
+    EXPECT_EQ(sum, 15);
+    EXPECT_EQ(std::ranges::data(arr), &arr[0]);
+    EXPECT_EQ(arr.end() - arr.begin(), 5);
+    EXPECT_EQ(arr.unchecked(4), 5);
+}
+
+TEST(ArrayTest, InsertAndEraseKeepOwnership) {
+    static_assert(is_trivially_relocatable_v<Point<double>>);
+    static_assert(is_trivially_relocatable_v<std::shared_ptr<int>>);
+    static_assert(is_trivially_relocatable_v<Array<int>>);
+    static_assert(is_trivially_relocatable_v<PmrArray<int>>);
+    static_assert(!is_trivially_relocatable_v<std::string>);
+
+    // shared_ptr переносится побайтно: счётчики ссылок не должны сбиться
+    auto shared = std::make_shared<int>(7);
+    Array<std::shared_ptr<int>> arr;
+    for (int i = 0; i < 10; ++i) {
+        arr.insert(arr.begin(), i % 2 ? shared : std::make_shared<int>(i));
+    }
+    EXPECT_EQ(shared.use_count(), 6);
+    EXPECT_EQ(*arr[0], 7);
+    EXPECT_EQ(*arr[9], 0);
+    auto next = arr.erase(arr.begin() + 2, arr.begin() + 6);
+    EXPECT_EQ(arr.size(), 6);
+    EXPECT_EQ(next, arr.begin() + 2);
+    EXPECT_EQ(shared.use_count(), 4);
+    arr.erase(arr.begin());
+    arr.shrink_to_fit();
+    EXPECT_EQ(arr.capacity(), 5);
+    EXPECT_EQ(shared.use_count(), 3);
+    EXPECT_THROW(arr.erase(arr.end()), std::out_of_range);
+    arr.clear();
+    EXPECT_EQ(shared.use_count(), 1);
+
+    // Тот же сценарий для типа, который сдвигается присваиванием
+    Array<std::string> words;
+    words.push_back("a");
+    words.push_back("d");
+    words.insert(words.begin() + 1, "c");
+    words.emplace(words.begin() + 1, 1, 'b');
+    words.insert(words.end(), "e");
+    words.erase(words.begin());
+    ASSERT_EQ(words.size(), 4);
+    EXPECT_EQ(words[0], "b");
+    EXPECT_EQ(words[3], "e");
+}
+
+TEST(ArrayTest, EmplaceFromOwnElementInMiddle) {
+    for (size_t reserved : {0, 16}) {
+        Array<std::string> arr;
+        arr.reserve(reserved);
+        arr.push_back("first");
+        arr.push_back("second");
+        arr.emplace(arr.begin() + 1, arr[1]);
+        arr.insert(arr.begin(), arr[2]);
+        ASSERT_EQ(arr.size(), 4);
+        EXPECT_EQ(arr[0], "second");
+        EXPECT_EQ(arr[1], "first");
+        EXPECT_EQ(arr[2], "second");
+    }
+}
+
+TEST(ArrayTest, GrowthFactorAndShrinkToFit) {
+    Array<int> arr;
+    EXPECT_DOUBLE_EQ(arr.growth_factor(), 2.0);
+    EXPECT_THROW(arr.set_growth_factor(1.0), std::invalid_argument);
+    arr.set_growth_factor(1.5);
+    size_t capacities[6] = {};
+    for (size_t i = 0; i < 6; ++i) {
+        arr.push_back(static_cast<int>(i));
+        capacities[i] = arr.capacity();
+    }
+    EXPECT_EQ(capacities[0], 1);
+    EXPECT_EQ(capacities[1], 2);
+    EXPECT_EQ(capacities[2], 3);
+    EXPECT_EQ(capacities[3], 4);
+    EXPECT_EQ(capacities[4], 6);
+    EXPECT_EQ(capacities[5], 6);
+
+    Array<int> copy(arr);
+    EXPECT_DOUBLE_EQ(copy.growth_factor(), 1.5);
+    copy.clear();
+    copy.shrink_to_fit();
+    EXPECT_EQ(copy.capacity(), 0);
+    EXPECT_EQ(copy.data(), nullptr);
+}
+
 // ==================== ТЕСТЫ ДЛЯ POINT CONTAINER ====================
 
 TEST(PointContainerTest, AddAndAccessPoints) {
@@ -175,6 +366,133 @@ TEST(PointContainerTest, MoveConstructor) {
     EXPECT_EQ(container1.size(), 0);
 }
 
+TEST(PointContainerTest, InlineCapacityForQuads) {
+    PointContainer<Point<int>> container;
+    const Point<int>* inline_storage = container.data();
+    for (int i = 0; i < 4; ++i) container.push_back(Point<int>(i, i));
+    EXPECT_EQ(container.capacity(), 4);
+    EXPECT_EQ(container.data(), inline_storage);
+}
+
+TEST(PointContainerTest, GrowBeyondInlineCapacity) {
+    PointContainer<Point<int>> container;
+    for (int i = 0; i < 100; ++i) container.push_back(Point<int>(i, -i));
+    EXPECT_EQ(container.size(), 100);
+    EXPECT_GE(container.capacity(), 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(container[i].getX(), i);
+        EXPECT_EQ(container[i].getY(), -i);
+    }
+}
+
+TEST(PointContainerTest, MoveHeapAndInlineStorage) {
+    PointContainer<Point<int>> small, large;
+    small.push_back(Point<int>(1, 2));
+    for (int i = 0; i < 10; ++i) large.push_back(Point<int>(i, i));
+    const Point<int>* heap_storage = large.data();
+
+    PointContainer<Point<int>> moved_large(std::move(large));
+    EXPECT_EQ(moved_large.data(), heap_storage);
+    EXPECT_EQ(moved_large.size(), 10);
+    EXPECT_EQ(large.size(), 0);
+
+    moved_large = std::move(small);
+    EXPECT_EQ(moved_large.size(), 1);
+    EXPECT_EQ(moved_large[0].getY(), 2);
+    EXPECT_EQ(small.size(), 0);
+}
+
+TEST(PointContainerTest, CopySharesHeapBufferUntilWrite) {
+    PointContainer<Point<int>> original;
+    for (int i = 0; i < 10; ++i) original.push_back(Point<int>(i, i));
+    PointContainer<Point<int>> copy(original);
+    EXPECT_EQ(std::as_const(copy).data(), std::as_const(original).data());
+    EXPECT_TRUE(copy.is_shared());
+
+    copy.push_back(Point<int>(10, 10));
+    EXPECT_NE(std::as_const(copy).data(), std::as_const(original).data());
+    EXPECT_FALSE(original.is_shared());
+    EXPECT_EQ(original.size(), 10);
+    EXPECT_EQ(copy.size(), 11);
+
+    // Неконстантный доступ тоже отделяет буфер
+    PointContainer<Point<int>> other;
+    other = original;
+    other[0] = Point<int>(-1, -1);
+    EXPECT_EQ(original[0].getX(), 0);
+    EXPECT_EQ(other[0].getX(), -1);
+    EXPECT_EQ(other[9].getX(), 9);
+
+    // Встроенные точки копируются
+    PointContainer<Point<int>> small;
+    small.push_back(Point<int>(1, 2));
+    PointContainer<Point<int>> small_copy(small);
+    EXPECT_NE(std::as_const(small_copy).data(), std::as_const(small).data());
+    EXPECT_FALSE(small_copy.is_shared());
+    EXPECT_EQ(small_copy[0].getY(), 2);
+}
+
+TEST(PointContainerTest, CopyAfterMutableAccessDoesNotAlias) {
+    PointContainer<Point<int>> original;
+    for (int i = 0; i < 10; ++i) original.push_back(Point<int>(i, i));
+    Point<int>& first = original[0];
+    Point<int>* data = original.data();
+    const PointContainer<Point<int>> snapshot(original);
+    EXPECT_FALSE(original.is_shared());
+    first = Point<int>(-1, -1);
+    data[9] = Point<int>(-9, -9);
+    EXPECT_EQ(snapshot[0].getX(), 0);
+    EXPECT_EQ(snapshot[9].getX(), 9);
+
+    // Новый буфер снова разделяется
+    for (int i = 10; i < 20; ++i) original.push_back(Point<int>(i, i));
+    const PointContainer<Point<int>> shared(original);
+    EXPECT_TRUE(original.is_shared());
+
+    // modify() не отдаёт ссылок: копия фигуры после преобразования разделяет вершины
+    Point<int> shape[] = {{0, 0}, {4, 0}, {5, 2}, {3, 5}, {0, 3}};
+    PolygonFigure<int> polygon{std::span<const Point<int>>(shape)};
+    polygon.transform(AffineTransform::translation(1, 1));
+    const PolygonFigure<int> copy(polygon);
+    EXPECT_EQ(&copy.get_point(4), &polygon.get_point(4));
+    EXPECT_EQ(copy.get_point(4).getY(), 4);
+
+    static_assert(std::is_nothrow_move_assignable_v<PointContainer<Point<int>>>);
+}
+
+TEST(PointContainerTest, CopiesAcrossResourcesAndThreads) {
+    CountingResource counter;
+    {
+        PointContainer<Point<int>> original(&counter);
+        for (int i = 0; i < 100; ++i) original.push_back(Point<int>(i, 2 * i));
+        const size_t allocations = counter.allocations();
+
+        // Другой ресурс — точки копируются
+        PointContainer<Point<int>> heap_copy(original, std::pmr::get_default_resource());
+        EXPECT_FALSE(original.is_shared());
+        EXPECT_EQ(heap_copy[99].getY(), 198);
+
+        // Копии в потоках разделяют буфер и не выделяют память
+        std::vector<std::thread> threads;
+        std::atomic<long> total{0};
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int k = 0; k < 1000; ++k) {
+                    PointContainer<Point<int>> copy(original);
+                    long sum = 0;
+                    for (const Point<int>& point : std::as_const(copy)) sum += point.getY();
+                    total += sum;
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        EXPECT_EQ(total.load(), 4L * 1000 * 9900);
+        EXPECT_EQ(counter.allocations(), allocations);
+        EXPECT_FALSE(original.is_shared());
+    }
+    EXPECT_EQ(counter.bytes_in_use(), 0u);
+}
+
 // ==================== ТЕСТЫ ДЛЯ SQUARE ====================
 
 TEST(SquareTest, AddPoints) {
@@ -353,6 +671,1843 @@ TEST(FigureContainerTest, TotalAreaCalculation) {
     EXPECT_DOUBLE_EQ(total_area, 4.0 + 6.0);
 }
 
+TEST(FigureContainerTest, ParallelAreasAndCenters) {
+    Array<std::shared_ptr<Figure<int>>> figures;
+    for (int i = 1; i <= 100; ++i) {
+        auto square = std::make_shared<Square<int>>();
+        square->add_point(Point<int>(0, 0));
+        square->add_point(Point<int>(i, 0));
+        square->add_point(Point<int>(i, i));
+        square->add_point(Point<int>(0, i));
+        figures.push_back(square);
+    }
+    EXPECT_DOUBLE_EQ(total_area(figures), 338350.0);
+    EXPECT_DOUBLE_EQ(total_area(std::execution::seq, figures), 338350.0);
+
+    Array<double> figure_areas = areas(figures);
+    Array<Point<int>> figure_centers = centers(figures);
+    ASSERT_EQ(figure_areas.size(), 100);
+    ASSERT_EQ(figure_centers.size(), 100);
+    EXPECT_DOUBLE_EQ(figure_areas[9], 100.0);
+    EXPECT_EQ(figure_centers[9].getX(), 5);
+    EXPECT_EQ(figure_centers[9].getY(), 5);
+}
+
+// ==================== ТЕСТЫ ДЛЯ FIGURE STORE ====================
+
+namespace {
+Array<std::shared_ptr<Figure<int>>> make_mixed_figures(int count) {
+    Array<std::shared_ptr<Figure<int>>> figures;
+    for (int i = 0; i < count; ++i) {
+        int s = i % 7 + 1;
+        int dx = i % 5 - 2, dy = i % 3 - 1;
+        Point<int> quad[] = {{dx, dy}, {dx + s, dy}, {dx + s, dy + 2 * s}, {dx, dy + 2 * s}};
+        Point<int> trap[] = {{dx, dy}, {dx + 2 * s, dy}, {dx + s + 1, dy + s}, {dx + 1, dy + s}};
+        switch (i % 3) {
+            case 0: figures.push_back(std::make_shared<Square<int>>(quad)); break;
+            case 1: figures.push_back(std::make_shared<Rectangle<int>>(quad)); break;
+            default: figures.push_back(std::make_shared<Trapezoid<int>>(trap)); break;
+        }
+    }
+    return figures;
+}
+}
+
+TEST(FigureStoreTest, LayoutIsStructureOfArrays) {
+    FigureStore<int> store = FigureStore<int>::from_figures(make_mixed_figures(6));
+    EXPECT_EQ(store.size(), 6);
+    EXPECT_EQ(store.vertex_count(), 24);
+    EXPECT_EQ(store.offsets().size(), 7);
+    EXPECT_EQ(store.offsets()[3], 12);
+    EXPECT_EQ(store.kind(0), FigureKind::Square);
+    EXPECT_EQ(store.kind(1), FigureKind::Rectangle);
+    EXPECT_EQ(store.kind(2), FigureKind::Trapezoid);
+    EXPECT_EQ(store.xs()[5], 1);  // вторая вершина прямоугольника: dx + s
+}
+
+TEST(FigureStoreTest, BatchResultsMatchFigures) {
+    auto figures = make_mixed_figures(50);
+    FigureStore<int> store = FigureStore<int>::from_figures(figures);
+    Array<double> store_areas = store.areas();
+    Array<Point<int>> store_centers = store.centers();
+    double expected_total = 0;
+    for (size_t i = 0; i < figures.size(); ++i) {
+        double area = static_cast<double>(*figures[i]);
+        expected_total += area;
+        EXPECT_EQ(store_areas[i], area);
+        EXPECT_EQ(store_centers[i].getX(), figures[i]->center().getX());
+        EXPECT_EQ(store_centers[i].getY(), figures[i]->center().getY());
+    }
+    EXPECT_EQ(store.total_area(), expected_total);
+}
+
+TEST(FigureStoreTest, RoundTripToFigures) {
+    auto figures = make_mixed_figures(9);
+    auto restored = FigureStore<int>::from_figures(figures).to_figures();
+    ASSERT_EQ(restored.size(), figures.size());
+    for (size_t i = 0; i < figures.size(); ++i) {
+        EXPECT_EQ(restored[i]->kind(), figures[i]->kind());
+        ASSERT_EQ(restored[i]->get_points_count(), 4);
+        EXPECT_EQ(restored[i]->get_point(2).getX(), figures[i]->get_point(2).getX());
+        EXPECT_EQ(restored[i]->get_point(2).getY(), figures[i]->get_point(2).getY());
+    }
+
+    // Не четырёхугольники и пустая фигура: центры store и фигур совпадают
+    Point<int> pentagon[] = {{-7, -3}, {-1, -3}, {0, 2}, {-4, 5}, {-9, 1}};
+    Point<int> triangle[] = {{-5, -5}, {-1, -5}, {-2, -1}};
+    Array<std::shared_ptr<Figure<int>>> odd;
+    odd.push_back(std::make_shared<Square<int>>(pentagon));
+    odd.push_back(std::make_shared<Rectangle<int>>(triangle));
+    odd.push_back(std::make_shared<Trapezoid<int>>(triangle));
+    odd.push_back(std::make_shared<Square<int>>(std::span<const Point<int>>()));
+    const FigureStore<int> store = FigureStore<int>::from_figures(odd);
+    const auto odd_restored = store.to_figures();
+    for (size_t i = 0; i < odd.size(); ++i) {
+        EXPECT_EQ(store.center(i).getX(), odd[i]->center().getX());
+        EXPECT_EQ(store.center(i).getY(), odd[i]->center().getY());
+        EXPECT_EQ(odd_restored[i]->center().getX(), odd[i]->center().getX());
+        EXPECT_EQ(odd_restored[i]->center().getY(), odd[i]->center().getY());
+    }
+    // Сумма -21 / 5 округляется вниз, как у PolygonFigure
+    EXPECT_EQ(odd[0]->center().getX(), -5);
+    EXPECT_EQ(odd[0]->center().getY(), 0);
+    EXPECT_EQ(odd[3]->center().getX(), 0);
+}
+
+TEST(FigureStoreTest, OutOfRangeAccess) {
+    FigureStore<double> store;
+    EXPECT_TRUE(store.empty());
+    EXPECT_THROW(store.area(0), std::out_of_range);
+    EXPECT_THROW(store.make_figure(0), std::out_of_range);
+}
+
+// ==================== ТЕСТЫ ДЛЯ VARIANT FIGURES ====================
+
+TEST(VariantFiguresTest, MatchesVirtualHierarchy) {
+    auto figures = make_mixed_figures(30);
+    auto variants = VariantFigures<int>::from_figures(figures);
+    ASSERT_EQ(variants.size(), figures.size());
+
+    Array<double> variant_areas = variants.areas();
+    Array<Point<int>> variant_centers = variants.centers();
+    for (size_t i = 0; i < figures.size(); ++i) {
+        EXPECT_EQ(variant_areas[i], static_cast<double>(*figures[i]));
+        EXPECT_EQ(variant_centers[i].getX(), figures[i]->center().getX());
+        EXPECT_EQ(variant_centers[i].getY(), figures[i]->center().getY());
+    }
+    EXPECT_DOUBLE_EQ(variants.total_area(), total_area(std::execution::seq, figures));
+}
+
+TEST(VariantFiguresTest, SortByKindBuildsBuckets) {
+    auto variants = VariantFigures<int>::from_figures(make_mixed_figures(10));
+    double unsorted_total = variants.total_area();
+    EXPECT_THROW(variants.bucket<Square<int>>(), std::logic_error);
+
+    variants.sort_by_kind();
+    EXPECT_TRUE(variants.sorted_by_kind());
+    EXPECT_EQ(variants.bucket<Square<int>>().size(), 4);
+    EXPECT_EQ(variants.bucket<Rectangle<int>>().size(), 3);
+    EXPECT_EQ(variants.bucket<Trapezoid<int>>().size(), 3);
+    EXPECT_TRUE(std::holds_alternative<Square<int>>(variants[3]));
+    EXPECT_TRUE(std::holds_alternative<Rectangle<int>>(variants[4]));
+    EXPECT_DOUBLE_EQ(variants.total_area(), unsorted_total);
+
+    size_t trapezoids = 0;
+    variants.for_each_of<Trapezoid<int>>([&](Trapezoid<int>& t) {
+        EXPECT_EQ(t.kind(), FigureKind::Trapezoid);
+        ++trapezoids;
+    });
+    EXPECT_EQ(trapezoids, 3);
+
+    // Изменение на месте сохраняет вид фигуры и группы
+    const double before = variants.visit(0, [](const auto& figure) { return figure.area(); });
+    variants.visit(0, [](auto& figure) { figure.add_point(Point<int>(5, 5)); });
+    EXPECT_TRUE(variants.sorted_by_kind());
+    EXPECT_TRUE(std::holds_alternative<Square<int>>(variants[0]));
+    EXPECT_EQ(variants.visit(0, [](const auto& figure) { return figure.get_points_count(); }), 5);
+    EXPECT_DOUBLE_EQ(variants.visit(0, [](const auto& figure) { return figure.area(); }), before);
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(variants[0])>>);
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(*variants.begin())>>);
+
+    Point<int> points[] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    variants.push_back(Square<int>(points));
+    EXPECT_FALSE(variants.sorted_by_kind());
+}
+
+// ==================== ТЕСТЫ ДЛЯ SIMD-ЯДЕР ====================
+
+namespace {
+template<class T>
+void expect_kernels_match_scalar() {
+    // Нечётное количество, чтобы проверить и хвост после векторной части
+    const size_t count = 77;
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> dist(-100000, 100000);
+    Array<T> xs, ys;
+    for (size_t i = 0; i < 4 * count; ++i) {
+        xs.push_back(static_cast<T>(dist(rng)) / static_cast<T>(std::is_integral_v<T> ? 1 : 7));
+        ys.push_back(static_cast<T>(dist(rng)) / static_cast<T>(std::is_integral_v<T> ? 1 : 3));
+    }
+    Array<double> expected_areas, actual_areas;
+    Array<T> expected_cx, expected_cy, actual_cx, actual_cy;
+    expected_areas.resize(count);
+    expected_cx.resize(count);
+    expected_cy.resize(count);
+    simd::quad_areas_scalar(xs.data(), ys.data(), count, expected_areas.data());
+    simd::quad_centers_scalar(xs.data(), ys.data(), count, expected_cx.data(), expected_cy.data());
+
+    for (simd::Level level : {simd::Level::SSE2, simd::Level::AVX2, simd::Level::AVX512}) {
+        SCOPED_TRACE(simd::level_name(level));
+        actual_areas.resize(count);
+        actual_cx.resize(count);
+        actual_cy.resize(count);
+        simd::quad_areas(xs.data(), ys.data(), count, actual_areas.data(), level);
+        simd::quad_centers(xs.data(), ys.data(), count, actual_cx.data(), actual_cy.data(), level);
+        EXPECT_EQ(std::memcmp(actual_areas.data(), expected_areas.data(), count * sizeof(double)), 0);
+        EXPECT_EQ(std::memcmp(actual_cx.data(), expected_cx.data(), count * sizeof(T)), 0);
+        EXPECT_EQ(std::memcmp(actual_cy.data(), expected_cy.data(), count * sizeof(T)), 0);
+    }
+}
+}
+
+TEST(SimdKernelTest, IntMatchesScalarBitForBit) {
+    expect_kernels_match_scalar<int>();
+}
+
+TEST(SimdKernelTest, FloatMatchesScalarBitForBit) {
+    expect_kernels_match_scalar<float>();
+}
+
+TEST(SimdKernelTest, DoubleMatchesScalarBitForBit) {
+    expect_kernels_match_scalar<double>();
+}
+
+TEST(SimdKernelTest, ScalarKernelMatchesFigures) {
+    Point<int> points[] = {{-3, -1}, {4, -1}, {3, 5}, {-1, 5}};
+    Trapezoid<int> trapezoid(points);
+    int xs[4], ys[4];
+    for (int i = 0; i < 4; ++i) {
+        xs[i] = points[i].getX();
+        ys[i] = points[i].getY();
+    }
+    double area;
+    int cx, cy;
+    simd::quad_areas(xs, ys, 1, &area);
+    simd::quad_centers(xs, ys, 1, &cx, &cy);
+    EXPECT_EQ(area, static_cast<double>(trapezoid));
+    EXPECT_EQ(cx, trapezoid.center().getX());
+    EXPECT_EQ(cy, trapezoid.center().getY());
+}
+
+// ==================== ТЕСТЫ ДЛЯ THREAD POOL ====================
+
+TEST(ThreadPoolTest, ParallelForCoversRangeOnce) {
+    ThreadPool pool(4);
+    Array<int> hits;
+    hits.resize(10007);
+    pool.parallel_for(hits.size(), 100, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) ++hits.unchecked(i);
+    });
+    for (int value : hits) EXPECT_EQ(value, 1);
+}
+
+TEST(ThreadPoolTest, NestedParallelForAndSubmit) {
+    ThreadPool pool(2);
+    std::atomic<int> total{0};
+    pool.parallel_for(8, 1, [&](size_t, size_t) {
+        pool.parallel_for(100, 10, [&](size_t begin, size_t end) {
+            total += static_cast<int>(end - begin);
+        });
+    });
+    EXPECT_EQ(total.load(), 800);
+
+    std::atomic<int> submitted{0};
+    for (int i = 0; i < 50; ++i) pool.submit([&] { ++submitted; });
+    while (submitted.load() < 50) std::this_thread::yield();
+}
+
+TEST(ThreadPoolTest, ExceptionIsRethrown) {
+    ThreadPool pool(2);
+    EXPECT_THROW(pool.parallel_for(100, 10, [](size_t begin, size_t) {
+        if (begin == 50) throw std::runtime_error("chunk failed");
+    }), std::runtime_error);
+}
+
+#if defined(__unix__)
+TEST(ThreadPoolTest, WaitBlocksWhileChunksRun) {
+    ThreadPool pool(2);
+    const std::thread::id caller = std::this_thread::get_id();
+    auto cpu_time = [] {
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+    };
+    auto before = cpu_time();
+    std::atomic<bool> worker_started{false};
+    // Блок вызывающего дожидается, пока рабочий поток возьмёт второй и
+    // уснёт: дальше красть нечего, и ожидание должно блокироваться на
+    // условной переменной, а не крутиться в цикле
+    pool.parallel_for(2, 1, [&](size_t, size_t) {
+        if (std::this_thread::get_id() == caller) {
+            while (!worker_started.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            before = cpu_time();
+        } else {
+            worker_started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    });
+    EXPECT_LT(cpu_time() - before, std::chrono::milliseconds(50));
+}
+#endif
+
+TEST(ThreadPoolTest, ReduceIsReproducibleAcrossThreadCounts) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    Array<double> values;
+    for (int i = 0; i < 100000; ++i) values.push_back(dist(rng));
+    auto identity = [](double v) { return v; };
+
+    ThreadPool one(1), four(4), eight(8);
+    double a = parallel_reduce(one, values, 0.0, identity, std::plus<>(), 1000);
+    double b = parallel_reduce(four, values, 0.0, identity, std::plus<>(), 1000);
+    double c = parallel_reduce(eight, values, 0.0, identity, std::plus<>(), 1000);
+    EXPECT_EQ(std::memcmp(&a, &b, sizeof(double)), 0);
+    EXPECT_EQ(std::memcmp(&a, &c, sizeof(double)), 0);
+}
+
+TEST(ThreadPoolTest, FigureAggregatesMatchSerial) {
+    ThreadPool pool(3);
+    auto figures = make_mixed_figures(1000);
+    EXPECT_DOUBLE_EQ(total_area(pool, figures, 64), total_area(std::execution::seq, figures));
+    Array<double> pool_areas = areas(pool, figures, 64);
+    Array<Point<int>> pool_centers = centers(pool, figures, 64);
+    for (size_t i = 0; i < figures.size(); ++i) {
+        EXPECT_EQ(pool_areas[i], static_cast<double>(*figures[i]));
+        EXPECT_EQ(pool_centers[i].getX(), figures[i]->center().getX());
+    }
+}
+
+// ==================== ТЕСТЫ ДЛЯ ЗАГРУЗЧИКА ====================
+
+TEST(FigureLoaderTest, ParsesRecordsWithoutPrompts) {
+    const char* text =
+        "# comment\n"
+        "square 0 0 2 0 2 2 0 2\n"
+        "\n"
+        "rectangle\t0 0 3 0 3 2 0 2\r\n"
+        "  trapezoid 0 0 4 0 3 3 1 3";
+    testing::internal::CaptureStdout();
+    LoadResult<int> result = parse_figures<int>(text);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+    EXPECT_EQ(result.errors.size(), 0);
+    ASSERT_EQ(result.figures.size(), 3);
+    EXPECT_EQ(result.figures[0]->kind(), FigureKind::Square);
+    EXPECT_EQ(result.figures[1]->kind(), FigureKind::Rectangle);
+    EXPECT_EQ(result.figures[2]->kind(), FigureKind::Trapezoid);
+    EXPECT_DOUBLE_EQ(static_cast<double>(*result.figures[1]), 6.0);
+    EXPECT_DOUBLE_EQ(static_cast<double>(*result.figures[2]), 9.0);
+}
+
+TEST(FigureLoaderTest, ReportsMalformedLinesWithNumbers) {
+    const char* text =
+        "square 0 0 2 0 2 2 0 2\n"
+        "circle 0 0 1\n"
+        "square 0 0 2 0 2 2 0\n"
+        "rectangle 0 0 3 x 3 2 0 2\n"
+        "trapezoid 0 0 4 0 3 3 1 3 5\n"
+        "rectangle 0 0 3 0 3 2 0 2\n";
+    LoadResult<int> result = parse_figures<int>(text);
+    EXPECT_EQ(result.figures.size(), 2);
+    ASSERT_EQ(result.errors.size(), 4);
+    EXPECT_EQ(result.errors[0].line, 2);
+    EXPECT_EQ(result.errors[0].message, "unknown figure kind 'circle'");
+    EXPECT_EQ(result.errors[1].line, 3);
+    EXPECT_EQ(result.errors[1].message, "expected 8 coordinates, got 7");
+    EXPECT_EQ(result.errors[2].line, 4);
+    EXPECT_EQ(result.errors[2].message, "invalid coordinate 'x'");
+    EXPECT_EQ(result.errors[3].line, 5);
+    EXPECT_EQ(result.errors[3].message, "unexpected trailing data");
+}
+
+TEST(FigureLoaderTest, LoadsFileIntoFiguresAndStore) {
+    const std::string path = testing::TempDir() + "figures_loader_test.txt";
+    {
+        std::ofstream out(path);
+        out << "square 0.5 0.5 2.5 0.5 2.5 2.5 0.5 2.5\n"
+            << "trapezoid 0 0 4 0 3 3 1 3\n";
+    }
+    LoadResult<double> loaded = load_figures<double>(path);
+    ASSERT_EQ(loaded.figures.size(), 2);
+    EXPECT_DOUBLE_EQ(loaded.figures[0]->center().getX(), 1.5);
+
+    StoreLoadResult<double> store = load_figure_store<double>(path);
+    EXPECT_EQ(store.store.size(), 2);
+    EXPECT_DOUBLE_EQ(store.store.total_area(), 4.0 + 9.0);
+    std::remove(path.c_str());
+
+    EXPECT_THROW(load_figures<int>(path), std::runtime_error);
+}
+
+TEST(FigureLoaderTest, PolygonsTakeAnyVertexCount) {
+    Point<int> triangle[] = {{0, 0}, {4, 0}, {0, 3}};
+    Point<int> pentagon[] = {{0, 0}, {6, 0}, {4, 3}, {1, 3}, {-1, 2}};
+    Array<std::shared_ptr<Figure<int>>> figures;
+    figures.push_back(make_figure<int>(FigureKind::Polygon, std::span<const Point<int>>(triangle)));
+    figures.push_back(make_figure<int>(FigureKind::Polygon, std::span<const Point<int>>(pentagon)));
+
+    // Вид и столбец points из CSV отчёта — готовая запись загрузчика
+    std::ostringstream csv;
+    {
+        ReportWriter<int> writer(csv, ReportFormat::Csv);
+        writer.begin();
+        writer.write(figures);
+    }
+    std::istringstream rows(csv.str());
+    std::string row, text;
+    std::getline(rows, row);
+    while (std::getline(rows, row)) {
+        const size_t kind_begin = row.find(',') + 1;
+        const size_t kind_end = row.find(',', kind_begin);
+        text += row.substr(kind_begin, kind_end - kind_begin) + " " + row.substr(row.rfind(',') + 1) + "\n";
+    }
+
+    LoadResult<int> loaded = parse_figures<int>(text);
+    EXPECT_EQ(loaded.errors.size(), 0);
+    ASSERT_EQ(loaded.figures.size(), 2);
+    for (size_t i = 0; i < 2; ++i) {
+        ASSERT_EQ(loaded.figures[i]->get_points_count(), figures[i]->get_points_count());
+        for (size_t v = 0; v < figures[i]->get_points_count(); ++v) {
+            EXPECT_EQ(loaded.figures[i]->get_point(v).getX(), figures[i]->get_point(v).getX());
+            EXPECT_EQ(loaded.figures[i]->get_point(v).getY(), figures[i]->get_point(v).getY());
+        }
+        EXPECT_EQ(loaded.figures[i]->area(), figures[i]->area());
+    }
+
+    StoreLoadResult<int> store = parse_figure_store<int>(text);
+    ASSERT_EQ(store.store.size(), 2);
+    EXPECT_EQ(store.store.area(1), figures[1]->area());
+
+    LoadResult<int> malformed = parse_figures<int>("polygon\npolygon 0 0 4 0 3\nsquare 0 0 2 0 2 2 0 2 1 1\n");
+    EXPECT_EQ(malformed.figures.size(), 0);
+    ASSERT_EQ(malformed.errors.size(), 3);
+    EXPECT_EQ(malformed.errors[0].message, "expected at least 2 coordinates, got 0");
+    EXPECT_EQ(malformed.errors[1].message, "expected an even number of coordinates, got 5");
+    EXPECT_EQ(malformed.errors[2].message, "unexpected trailing data");
+}
+
+// ==================== ТЕСТЫ ДЛЯ ДВОИЧНОГО ФОРМАТА ====================
+
+TEST(FigureFileTest, RoundTripMatchesFigures) {
+    const std::string path = testing::TempDir() + "figures_file_test.bin";
+    auto figures = make_mixed_figures(37);
+    write_figure_file(path, figures);
+
+    FigureFileView<int> view(path);
+    EXPECT_TRUE(view.validate());
+    ASSERT_EQ(view.size(), figures.size());
+    EXPECT_EQ(view.vertex_count(), figures.size() * 4);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(view.columns().xs.data()) % figure_file::alignment, 0);
+
+    Array<double> areas = view.areas();
+    Array<Point<int>> centers = view.centers();
+    for (size_t i = 0; i < figures.size(); ++i) {
+        EXPECT_EQ(view.kind(i), figures[i]->kind());
+        EXPECT_DOUBLE_EQ(areas[i], static_cast<double>(*figures[i]));
+        EXPECT_EQ(centers[i].getX(), figures[i]->center().getX());
+        EXPECT_EQ(centers[i].getY(), figures[i]->center().getY());
+        EXPECT_EQ(view.center(i).getX(), figures[i]->center().getX());
+    }
+    EXPECT_DOUBLE_EQ(view.total_area(), total_area(figures));
+    EXPECT_EQ(view.make_figure(2)->kind(), FigureKind::Trapezoid);
+    std::remove(path.c_str());
+}
+
+TEST(FigureFileTest, EmptyStoreRoundTrip) {
+    const std::string path = testing::TempDir() + "figures_file_empty.bin";
+    write_figure_file(path, FigureStore<double>());
+    FigureFileView<double> view(path);
+    EXPECT_EQ(view.size(), 0);
+    EXPECT_DOUBLE_EQ(view.total_area(), 0.0);
+    std::remove(path.c_str());
+}
+
+TEST(FigureFileTest, RejectsWrongTypeAndCorruptedFiles) {
+    const std::string path = testing::TempDir() + "figures_file_bad.bin";
+    write_figure_file(path, make_mixed_figures(5));
+    EXPECT_THROW(FigureFileView<double> view(path), std::runtime_error);
+
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.write("NOTFIGS", 7);
+    }
+    EXPECT_THROW(FigureFileView<int> view(path), std::runtime_error);
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "square 0 0 2 0 2 2 0 2\n";
+    }
+    EXPECT_THROW(FigureFileView<int> view(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(FigureFileView<int> view(path), std::runtime_error);
+}
+
+TEST(FigureFileTest, CraftedFlagsAndOffsetsStayInBounds) {
+    const std::string path = testing::TempDir() + "figures_file_crafted.bin";
+    FigureStore<int> store;
+    Point<int> quad[] = {{0, 0}, {2, 0}, {2, 2}, {0, 2}};
+    Point<int> pentagon[] = {{0, 0}, {4, 0}, {4, 3}, {2, 5}, {0, 3}};
+    store.push_back(FigureKind::Square, quad);
+    store.push_back(FigureKind::Polygon, pentagon);
+    store.push_back(FigureKind::Trapezoid, quad);
+
+    auto patch = [&](auto edit) {
+        write_figure_file(path, store);
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        FigureFileHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        edit(file, header);
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    };
+
+    // Флаг четырёхугольников при 13 вершинах у трёх фигур
+    patch([](std::fstream&, FigureFileHeader& header) { header.flags |= figure_file::flag_all_quads; });
+    EXPECT_THROW(FigureFileView<int> view(path), std::runtime_error);
+
+    // Смещение второй фигуры далеко за столбцами координат
+    patch([](std::fstream& file, FigureFileHeader& header) {
+        const std::uint64_t huge = std::uint64_t(1) << 40;
+        file.seekp(static_cast<std::streamoff>(header.offsets_offset + 2 * sizeof(std::uint64_t)));
+        file.write(reinterpret_cast<const char*>(&huge), sizeof(huge));
+    });
+    {
+        FigureFileView<int> view(path);
+        EXPECT_FALSE(view.validate());
+        EXPECT_DOUBLE_EQ(view.area(0), 4.0);
+        EXPECT_THROW(view.area(1), std::runtime_error);
+        EXPECT_THROW(view.center(2), std::runtime_error);
+        EXPECT_THROW(view.make_figure(1), std::runtime_error);
+        EXPECT_THROW(view.total_area(), std::runtime_error);
+    }
+    std::remove(path.c_str());
+}
+
+// ==================== ТЕСТЫ ДЛЯ АРЕНЫ И PMR ====================
+
+TEST(ArenaTest, PmrArrayUsesResource) {
+    CountingResource counter;
+    PmrArray<int> arr(&counter);
+    for (int i = 0; i < 100; ++i) {
+        arr.push_back(i);
+    }
+    EXPECT_GT(counter.allocations(), 0);
+    EXPECT_EQ(counter.bytes_in_use(), arr.capacity() * sizeof(int));
+
+    // Копия без явного аллокатора берёт ресурс по умолчанию
+    PmrArray<int> copy(arr);
+    EXPECT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copy[99], 99);
+
+    CountingResource other;
+    PmrArray<int> moved(std::move(arr), &other);
+    EXPECT_EQ(moved.size(), 100);
+    EXPECT_EQ(moved[42], 42);
+    EXPECT_EQ(other.bytes_in_use(), moved.capacity() * sizeof(int));
+
+    // Присваивание сохраняет собственный ресурс
+    moved = copy;
+    EXPECT_EQ(moved.get_allocator().resource(), &other);
+    EXPECT_EQ(moved[7], 7);
+}
+
+TEST(ArenaTest, NestedPmrArraysShareResource) {
+    CountingResource counter;
+    PmrArray<PmrArray<int>> outer(&counter);
+    outer.emplace_back();
+    outer[0].push_back(1);
+    EXPECT_EQ(outer[0].get_allocator().resource(), &counter);
+}
+
+TEST(ArenaTest, PointContainerSpillsIntoResource) {
+    CountingResource counter;
+    PointContainer<Point<int>> points(&counter);
+    for (int i = 0; i < 4; ++i) {
+        points.push_back(Point<int>(i, i));
+    }
+    EXPECT_EQ(counter.allocations(), 0);
+    points.push_back(Point<int>(4, 4));
+    EXPECT_EQ(counter.allocations(), 1);
+
+    PointContainer<Point<int>> moved(std::move(points));
+    EXPECT_EQ(moved.resource(), &counter);
+    EXPECT_EQ(moved[4].getX(), 4);
+
+    // Контейнер с другим ресурсом копирует точки в свою память
+    PointContainer<Point<int>> other;
+    other = std::move(moved);
+    EXPECT_EQ(other.resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(other.size(), 5);
+    EXPECT_TRUE(moved.empty());
+}
+
+TEST(ArenaTest, FiguresLoadedIntoArena) {
+    std::string text;
+    for (int i = 0; i < 1000; ++i) {
+        text += "trapezoid 0 0 4 0 3 3 1 3\n";
+    }
+    CountingResource upstream;
+    {
+        FigureArena arena(FigureArena::default_block_size, &upstream);
+        LoadResult<int> result = parse_figures<int>(text, &arena);
+        ASSERT_EQ(result.figures.size(), 1000);
+        EXPECT_DOUBLE_EQ(total_area(result.figures), 9000.0);
+        // Тысяча фигур умещается в один блок арены
+        EXPECT_EQ(upstream.allocations(), 1);
+    }
+    EXPECT_EQ(upstream.bytes_in_use(), 0);
+}
+
+// ==================== ТЕСТЫ ДЛЯ КЭША И ОТСЛЕЖИВАНИЯ ИЗМЕНЕНИЙ ====================
+
+TEST(FigureCacheTest, AreaCenterAndBoxAreCachedAndInvalidated) {
+    Point<int> points[] = {{0, 0}, {4, 0}, {3, 3}};
+    const Trapezoid<int> triangle{std::span<const Point<int>>(points)};
+    EXPECT_DOUBLE_EQ(triangle.area(), 6.0);
+    EXPECT_DOUBLE_EQ(static_cast<double>(triangle), 6.0);
+    BoundingBox<int> box = triangle.bounding_box();
+    EXPECT_EQ(box.min.getX(), 0);
+    EXPECT_EQ(box.max.getX(), 4);
+    EXPECT_EQ(box.max.getY(), 3);
+
+    Trapezoid<int> trapezoid(triangle);
+    EXPECT_DOUBLE_EQ(trapezoid.area(), 6.0);
+    const auto version = trapezoid.version();
+    trapezoid.add_point(Point<int>(1, 3));
+    EXPECT_GT(trapezoid.version(), version);
+    EXPECT_DOUBLE_EQ(trapezoid.area(), 9.0);
+    EXPECT_EQ(trapezoid.center().getX(), 2);
+    EXPECT_EQ(trapezoid.bounding_box().max.getY(), 3);
+
+    trapezoid = Trapezoid<int>(triangle);
+    EXPECT_DOUBLE_EQ(trapezoid.area(), 6.0);
+
+    // Перемещённая фигура остаётся пустой и не отдаёт старые кэши
+    const auto moved_version = trapezoid.version();
+    Trapezoid<int> moved(std::move(trapezoid));
+    EXPECT_DOUBLE_EQ(moved.area(), 6.0);
+    EXPECT_EQ(trapezoid.get_points_count(), 0);
+    EXPECT_GT(trapezoid.version(), moved_version);
+    EXPECT_DOUBLE_EQ(trapezoid.area(), 0.0);
+    EXPECT_EQ(trapezoid.center().getX(), 0);
+}
+
+TEST(FigureCacheTest, ConcurrentReadersSeeSameValue) {
+    auto figures = make_mixed_figures(3);
+    std::shared_ptr<Figure<int>> figure = figures[2];
+    Array<std::shared_ptr<Figure<int>>> repeated;
+    for (int i = 0; i < 10000; ++i) {
+        repeated.push_back(figure);
+    }
+    ThreadPool pool(4);
+    EXPECT_DOUBLE_EQ(total_area(pool, repeated, 64), 10000 * figure->area());
+}
+
+TEST(FigureCacheTest, CopiesSharePointsUntilModified) {
+    Array<Point<int>> vertices;
+    for (int i = 0; i < 64; ++i) {
+        vertices.emplace_back(static_cast<int>(100 * std::cos(i * 0.1)), static_cast<int>(100 * std::sin(i * 0.1)));
+    }
+    PolygonFigure<int> original{std::span<const Point<int>>(vertices.data(), vertices.size())};
+    const double area = original.area();
+
+    PolygonFigure<int> copy(original);
+    EXPECT_EQ(&copy.get_point(0), &original.get_point(0));
+    EXPECT_DOUBLE_EQ(copy.area(), area);
+
+    copy.add_point(Point<int>(0, 0));
+    EXPECT_NE(&copy.get_point(0), &original.get_point(0));
+    EXPECT_EQ(original.get_points_count(), 64);
+    EXPECT_DOUBLE_EQ(original.area(), area);
+    EXPECT_NE(copy.area(), area);
+
+    // Копия коллекции — O(1) на фигуру: буферы общие
+    Array<PolygonFigure<int>> collection;
+    collection.push_back(original);
+    Array<PolygonFigure<int>> snapshot(collection);
+    EXPECT_EQ(&snapshot[0].get_point(63), &original.get_point(63));
+}
+
+TEST(TrackedFiguresTest, RecomputesOnlyChangedFigures) {
+    TrackedFigures<int> tracked(make_mixed_figures(30));
+    EXPECT_EQ(tracked.dirty_count(), 30);
+    const double total = tracked.total_area();
+    EXPECT_DOUBLE_EQ(total, total_area(make_mixed_figures(30)));
+    EXPECT_EQ(tracked.refresh(), 0);
+
+    tracked.modify(2, [](Figure<int>& figure) { figure.add_point(Point<int>(0, 0)); });
+    EXPECT_EQ(tracked.dirty_count(), 1);
+    EXPECT_EQ(tracked.refresh(), 1);
+    EXPECT_DOUBLE_EQ(tracked.areas()[2], tracked[2].area());
+}
+
+TEST(TrackedFiguresTest, TotalFollowsChangedFiguresOnly) {
+    Array<std::shared_ptr<Figure<double>>> figures;
+    for (int i = 0; i < 1000; ++i) {
+        const double w = 1.0 + i % 7, h = 0.1 * (1 + i % 11);
+        Point<double> quad[] = {{0, 0}, {w, 0}, {w, h}, {0, h}};
+        figures.push_back(std::make_shared<Rectangle<double>>(quad));
+    }
+    TrackedFigures<double> tracked(figures);
+    tracked.refresh();
+    auto expected = [&] { return total_area(std::execution::seq, figures); };
+
+    // Много поправок одной фигуры не уводят сумму
+    for (int step = 0; step < 10000; ++step) {
+        const double s = step % 2 == 0 ? 3.0 : 1.0 / 3.0;
+        tracked.modify(17, [&](Figure<double>& figure) { figure.transform(AffineTransform::scaling(s)); });
+        EXPECT_EQ(tracked.refresh(), 1);
+    }
+    EXPECT_NEAR(tracked.total_area(), expected(), 1e-9 * expected());
+
+    // Неконечная площадь и возврат к конечной
+    tracked.modify(3, [](Figure<double>& figure) { figure.transform(AffineTransform::scaling(1e200)); });
+    EXPECT_FALSE(std::isfinite(tracked.total_area()));
+    tracked.modify(3, [](Figure<double>& figure) { figure.transform(AffineTransform::scaling(1e-200)); });
+    EXPECT_NEAR(tracked.total_area(), expected(), 1e-9 * expected());
+}
+
+TEST(TrackedFiguresTest, DetectsChangesByVersion) {
+    auto figures = make_mixed_figures(6);
+    TrackedFigures<int> tracked(figures);
+    tracked.refresh();
+    figures[5]->add_point(Point<int>(1, 1));
+    figures[4]->add_point(Point<int>(2, 2));
+    EXPECT_EQ(tracked.detect_changes(), 2);
+    EXPECT_EQ(tracked.refresh(), 2);
+    EXPECT_EQ(tracked.centers()[5].getX(), figures[5]->center().getX());
+    EXPECT_EQ(tracked.detect_changes(), 0);
+}
+
+// ==================== ТЕСТЫ ДЛЯ СЧЁТЧИКОВ ====================
+
+TEST(InstrumentationTest, CountsArrayAndFigureEvents) {
+    if (!instrumentation::enabled) GTEST_SKIP() << "built without FIGURES_INSTRUMENTATION";
+    instrumentation::reset();
+
+    Array<int> arr;
+    for (int i = 0; i < 5; ++i) {
+        arr.push_back(i);
+    }
+    Array<int> copy(arr);
+    Array<int> moved(std::move(copy));
+    EXPECT_THROW(arr[10], std::out_of_range);
+
+    auto s = instrumentation::snapshot<Array<int>>();
+    EXPECT_EQ(s.type, "Array<int>");
+    EXPECT_EQ(s.allocations, 5);  // 1, 2, 4, 8 и копия
+    EXPECT_EQ(s.bytes, (1 + 2 + 4 + 8 + 5) * sizeof(int));
+    EXPECT_EQ(s.reallocations, 4);
+    EXPECT_EQ(s.relocated, 0 + 1 + 2 + 4);
+    EXPECT_EQ(s.copies, 1);
+    EXPECT_EQ(s.moves, 1);
+    EXPECT_EQ(s.bounds_failures, 1);
+
+    Point<int> points[] = {{0, 0}, {2, 0}, {2, 2}, {0, 2}};
+    Square<int> square{std::span<const Point<int>>(points)};
+    Square<int> square_copy(square);
+    EXPECT_EQ(instrumentation::snapshot<Figure<int>>().copies, 1);
+
+    std::ostringstream out;
+    instrumentation::dump(out);
+    EXPECT_NE(out.str().find("Array<int>"), std::string::npos);
+}
+
+TEST(InstrumentationTest, DisabledBuildIsEmpty) {
+    if (instrumentation::enabled) GTEST_SKIP() << "built with FIGURES_INSTRUMENTATION";
+    Array<int> arr;
+    arr.push_back(1);
+    Array<int> copy(arr);
+    EXPECT_EQ(instrumentation::snapshot<Array<int>>().copies, 0);
+    std::ostringstream out;
+    instrumentation::dump(out);
+    EXPECT_NE(out.str().find("disabled"), std::string::npos);
+}
+
+// ==================== ТЕСТЫ ДЛЯ FIXEDPOLYGON ====================
+
+TEST(FixedPolygonTest, EvaluatesAtCompileTime) {
+    constexpr FixedQuad<int> square({Point<int>(0, 0), Point<int>(2, 0), Point<int>(2, 2), Point<int>(0, 2)});
+    static_assert(square.area() == 4.0);
+    static_assert(square.center().getX() == 1 && square.center().getY() == 1);
+    static_assert(square.perimeter() == 8.0);
+
+    constexpr FixedTriangle<double> triangle({Point<double>(0, 0), Point<double>(3, 0), Point<double>(0, 4)});
+    static_assert(triangle.area() == 6.0);
+    static_assert(triangle.perimeter() == 12.0);
+    EXPECT_EQ(FixedTriangle<double>::size(), 3);
+    EXPECT_THROW(triangle[3], std::out_of_range);
+}
+
+TEST(FixedPolygonTest, MatchesRuntimeFigures) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coord(-50, 50);
+    for (int iteration = 0; iteration < 100; ++iteration) {
+        std::array<Point<int>, 4> points;
+        for (auto& point : points) {
+            point = Point<int>(coord(rng), coord(rng));
+        }
+        FixedQuad<int> quad(points);
+        Trapezoid<int> trapezoid{std::span<const Point<int>>(points)};
+        EXPECT_EQ(quad.area(), trapezoid.area());
+        EXPECT_EQ(quad.center().getX(), trapezoid.center().getX());
+        EXPECT_EQ(quad.center().getY(), trapezoid.center().getY());
+    }
+    constexpr FixedTriangle<double> triangle({Point<double>(0, 0), Point<double>(3, 0), Point<double>(0, 4)});
+    double runtime_perimeter = triangle.perimeter();
+    EXPECT_DOUBLE_EQ(runtime_perimeter, 12.0);
+
+    // Периметр во время выполнения: тот же порядок рёбер и std::sqrt, что у
+    // PolygonFigure, — совпадение бит в бит. При компиляции корень считается
+    // методом Ньютона и может отличаться в последнем бите, поэтому сравнение
+    // с ним — с точностью до нескольких ulp
+    constexpr FixedPolygon<double, 5> pentagon({Point<double>(0.1, 0), Point<double>(6.3, 0.7),
+                                                Point<double>(4, 3.3), Point<double>(1, 3),
+                                                Point<double>(-1.9, 2.2)});
+    const PolygonFigure<double> figure{std::span<const Point<double>>(pentagon.vertices())};
+    EXPECT_EQ(pentagon.perimeter(), figure.perimeter());
+    constexpr double compile_time_perimeter = pentagon.perimeter();
+    EXPECT_DOUBLE_EQ(compile_time_perimeter, figure.perimeter());
+}
+
+TEST(FixedPolygonTest, CenterWithNegativeCoordinates) {
+    constexpr FixedTriangle<int> triangle({Point<int>(-3, -3), Point<int>(-6, -3), Point<int>(-3, -9)});
+    static_assert(triangle.center().getX() == -4 && triangle.center().getY() == -5);
+
+    // Суммы -26 и -39 не делятся на 5: округление вниз
+    FixedPolygon<int, 5> pentagon({Point<int>(-2, -4), Point<int>(-8, -4), Point<int>(-10, -9),
+                                   Point<int>(-5, -13), Point<int>(-1, -9)});
+    EXPECT_EQ(pentagon.center().getX(), -6);
+    EXPECT_EQ(pentagon.center().getY(), -8);
+
+    FixedPolygon<double, 5> real({Point<double>(-2, -4), Point<double>(-8, -4), Point<double>(-10, -9),
+                                  Point<double>(-5, -13), Point<double>(-1, -9)});
+    EXPECT_DOUBLE_EQ(real.center().getX(), -5.2);
+    EXPECT_DOUBLE_EQ(real.center().getY(), -7.8);
+}
+
+TEST(FixedPolygonTest, AdapterProvidesFigureInterface) {
+    FixedPolygon<int, 5> pentagon({Point<int>(0, 0), Point<int>(4, 0), Point<int>(4, 3), Point<int>(2, 5), Point<int>(0, 3)});
+    std::shared_ptr<Figure<int>> figure = make_figure(pentagon);
+    EXPECT_EQ(figure->kind(), FigureKind::Polygon);
+    EXPECT_EQ(figure->get_points_count(), 5);
+    EXPECT_DOUBLE_EQ(figure->area(), pentagon.area());
+    EXPECT_EQ(figure->center().getX(), pentagon.center().getX());
+
+    Array<std::shared_ptr<Figure<int>>> figures;
+    figures.push_back(figure);
+    figures.push_back(make_figure(FixedQuad<int>({Point<int>(0, 0), Point<int>(2, 0), Point<int>(2, 2), Point<int>(0, 2)})));
+    EXPECT_DOUBLE_EQ(total_area(figures), 4.0 + pentagon.area());
+
+    FigureStore<int> store = FigureStore<int>::from_figures(figures);
+    EXPECT_DOUBLE_EQ(store.area(0), pentagon.area());
+    EXPECT_EQ(store.make_figure(1)->kind(), FigureKind::Polygon);
+
+    LoadResult<int> loaded = parse_figures<int>("polygon 0 0 4 0 3 3 1 3\n");
+    ASSERT_EQ(loaded.figures.size(), 1);
+    EXPECT_DOUBLE_EQ(loaded.figures[0]->area(), 9.0);
+}
+
+// ==================== ТЕСТЫ ДЛЯ ПРОСТРАНСТВЕННОГО ИНДЕКСА ====================
+
+namespace {
+// Фигуры, разбросанные по квадрату 10000 x 10000
+Array<std::shared_ptr<Figure<int>>> make_scattered_figures(int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> coord(0, 10000), size(1, 50);
+    Array<std::shared_ptr<Figure<int>>> figures;
+    for (int i = 0; i < count; ++i) {
+        int x = coord(rng), y = coord(rng), w = size(rng), h = size(rng);
+        Point<int> quad[] = {{x, y}, {x + w, y}, {x + w, y + h}, {x, y + h}};
+        figures.push_back(make_figure<int>(static_cast<FigureKind>(i % 3), std::span<const Point<int>>(quad)));
+    }
+    return figures;
+}
+
+Array<size_t> linear_window(const Array<std::shared_ptr<Figure<int>>>& figures, const BoundingBox<int>& window) {
+    Array<size_t> result;
+    for (size_t i = 0; i < figures.size(); ++i) {
+        BoundingBox<int> box = figures[i]->bounding_box();
+        if (box.min.getX() <= window.max.getX() && window.min.getX() <= box.max.getX()
+            && box.min.getY() <= window.max.getY() && window.min.getY() <= box.max.getY()) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+double squared_distance(const Point<int>& a, const Point<int>& b) {
+    double dx = a.getX() - b.getX(), dy = a.getY() - b.getY();
+    return dx * dx + dy * dy;
+}
+}
+
+TEST(SpatialIndexTest, WindowQueryMatchesLinearScan) {
+    auto figures = make_scattered_figures(5000, 1);
+    SpatialIndex<int> index(figures);
+    EXPECT_EQ(index.size(), 5000);
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> coord(0, 10000);
+    for (int q = 0; q < 50; ++q) {
+        int x = coord(rng), y = coord(rng);
+        BoundingBox<int> window{Point<int>(x, y), Point<int>(x + 700, y + 400)};
+        Array<size_t> found = index.query(window);
+        std::sort(found.begin(), found.end());
+        Array<size_t> expected = linear_window(figures, window);
+        ASSERT_EQ(found.size(), expected.size());
+        EXPECT_TRUE(std::equal(found.begin(), found.end(), expected.begin()));
+    }
+}
+
+TEST(SpatialIndexTest, NearestMatchesBruteForce) {
+    auto figures = make_scattered_figures(3000, 3);
+    SpatialIndex<int> index(figures);
+    Point<int> query(5000, 5000);
+    Array<size_t> nearest = index.nearest(query, 10);
+    ASSERT_EQ(nearest.size(), 10);
+
+    Array<double> distances;
+    for (const auto& figure : figures) {
+        distances.push_back(squared_distance(figure->center(), query));
+    }
+    std::sort(distances.begin(), distances.end());
+    for (size_t i = 0; i < nearest.size(); ++i) {
+        EXPECT_DOUBLE_EQ(squared_distance(figures[nearest[i]]->center(), query), distances[i]);
+    }
+    EXPECT_EQ(index.nearest(query, 0).size(), 0);
+    EXPECT_EQ(index.nearest(query, 5000).size(), 3000);
+}
+
+TEST(SpatialIndexTest, IncrementalInsert) {
+    auto figures = make_scattered_figures(2000, 4);
+    SpatialIndex<int> index;
+    for (const auto& figure : figures) {
+        index.insert(figure);
+        EXPECT_LE(index.pending(), std::max<size_t>(SpatialIndex<int>::min_pending, index.size() / 4));
+    }
+    EXPECT_EQ(index.size(), 2000);
+    BoundingBox<int> window{Point<int>(2000, 2000), Point<int>(6000, 3000)};
+    Array<size_t> found = index.query(window);
+    std::sort(found.begin(), found.end());
+    Array<size_t> expected = linear_window(figures, window);
+    ASSERT_EQ(found.size(), expected.size());
+    EXPECT_TRUE(std::equal(found.begin(), found.end(), expected.begin()));
+    EXPECT_THROW(index.insert(nullptr), std::invalid_argument);
+}
+
+// ==================== ТЕСТЫ ДЛЯ ПРИНАДЛЕЖНОСТИ ТОЧЕК ====================
+
+TEST(ContainsTest, AxisAlignedFastPathMatchesPolygonTest) {
+    Point<int> quad[] = {{-3, -2}, {5, -2}, {5, 4}, {-3, 4}};
+    Rectangle<int> rectangle{std::span<const Point<int>>(quad)};
+    PolygonFigure<int> polygon{std::span<const Point<int>>(quad)};
+
+    Array<Point<int>> points;
+    for (int x = -6; x <= 8; ++x) {
+        for (int y = -5; y <= 7; ++y) {
+            points.emplace_back(x, y);
+        }
+    }
+    std::span<const Point<int>> query(points.data(), points.size());
+    Array<bool> fast = rectangle.contains(query);
+    Array<bool> general = polygon.contains(query);
+    for (size_t k = 0; k < points.size(); ++k) {
+        bool expected = points[k].getX() >= -3 && points[k].getX() <= 5
+                     && points[k].getY() >= -2 && points[k].getY() <= 4;
+        EXPECT_EQ(fast[k], expected) << k;
+        EXPECT_EQ(general[k], expected) << k;
+    }
+
+    // Вершины на линиях, параллельных осям, но не углы прямоугольника:
+    // быстрый путь не применяется, ответ — как у общего метода
+    Point<int> degenerate[][4] = {{{0, 0}, {2, 0}, {2, 2}, {2, 0}},
+                                  {{0, 0}, {2, 0}, {2, 0}, {0, 0}},
+                                  {{0, 0}, {0, 0}, {0, 0}, {0, 0}},
+                                  {{0, 0}, {2, 0}, {2, 2}, {0, 2}}};
+    Point<int> probes[] = {{1, 1}, {2, 1}, {1, 0}, {0, 0}, {3, 3}};
+    std::span<const Point<int>> probe_span(probes);
+    for (const auto& vertices : degenerate) {
+        const Square<int> square{std::span<const Point<int>>(vertices)};
+        const Rectangle<int> rect{std::span<const Point<int>>(vertices)};
+        const PolygonFigure<int> reference{std::span<const Point<int>>(vertices)};
+        Array<bool> expected = reference.contains(probe_span);
+        Array<bool> from_square = square.contains(probe_span);
+        Array<bool> from_rect = rect.contains(probe_span);
+        for (size_t k = 0; k < std::size(probes); ++k) {
+            EXPECT_EQ(from_square[k], expected[k]) << k;
+            EXPECT_EQ(from_rect[k], expected[k]) << k;
+        }
+    }
+    const Square<int> overlapped{std::span<const Point<int>>(degenerate[0])};
+    EXPECT_FALSE(overlapped.contains(Point<int>(1, 1)));
+}
+
+TEST(ContainsTest, TrapezoidAndConcavePolygon) {
+    Point<int> trap[] = {{0, 0}, {4, 0}, {3, 3}, {1, 3}};
+    Trapezoid<int> trapezoid{std::span<const Point<int>>(trap)};
+    EXPECT_TRUE(trapezoid.contains(Point<int>(2, 1)));
+    EXPECT_TRUE(trapezoid.contains(Point<int>(0, 0)));      // вершина
+    EXPECT_TRUE(trapezoid.contains(Point<int>(2, 3)));      // верхнее основание
+    EXPECT_FALSE(trapezoid.contains(Point<int>(0, 3)));
+    EXPECT_FALSE(trapezoid.contains(Point<int>(5, 1)));
+
+    // Буква «П»: выемка сверху
+    Point<double> shape[] = {{0, 0}, {3, 0}, {3, 3}, {2, 3}, {2, 1}, {1, 1}, {1, 3}, {0, 3}};
+    PolygonFigure<double> polygon{std::span<const Point<double>>(shape)};
+    Point<double> queries[] = {{0.5, 2.5}, {1.5, 2.5}, {1.5, 0.5}, {2.5, 2.0}, {1.5, 1.0}, {4.0, 1.0}};
+    bool out[6];
+    polygon.contains(std::span<const Point<double>>(queries), std::span<bool>(out));
+    EXPECT_TRUE(out[0]);
+    EXPECT_FALSE(out[1]);
+    EXPECT_TRUE(out[2]);
+    EXPECT_TRUE(out[3]);
+    EXPECT_TRUE(out[4]);
+    EXPECT_FALSE(out[5]);
+    EXPECT_THROW(polygon.contains(std::span<const Point<double>>(queries), std::span<bool>(out, 2)),
+                 std::invalid_argument);
+}
+
+TEST(ContainsTest, RotatedSquareFallsBackToPolygonTest) {
+    Point<int> diamond[] = {{0, -2}, {2, 0}, {0, 2}, {-2, 0}};
+    Square<int> square{std::span<const Point<int>>(diamond)};
+    EXPECT_TRUE(square.contains(Point<int>(0, 0)));
+    EXPECT_TRUE(square.contains(Point<int>(1, 1)));
+    EXPECT_FALSE(square.contains(Point<int>(2, 2)));
+
+    // Много точек: несколько блоков, часть целиком вне габарита
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> coord(-10, 10);
+    Array<Point<int>> points;
+    for (int i = 0; i < 1000; ++i) {
+        points.emplace_back(coord(rng), coord(rng));
+    }
+    Array<bool> inside = square.contains(std::span<const Point<int>>(points.data(), points.size()));
+    for (size_t k = 0; k < points.size(); ++k) {
+        EXPECT_EQ(inside[k], std::abs(points[k].getX()) + std::abs(points[k].getY()) <= 2) << k;
+    }
+}
+
+TEST(ContainsTest, AllInstructionSetsAgree) {
+    Point<double> shape[] = {{0, 0}, {3, 0}, {3, 3}, {2, 3}, {2, 1}, {1, 1}, {1, 3}, {0, 3}};
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> coord(-1.0, 4.0);
+    Array<Point<double>> points;
+    for (int i = 0; i < 500; ++i) {
+        // Половина точек — на сетке с шагом 0.5, чтобы часть попала на рёбра
+        if (i % 2) points.emplace_back(coord(rng), coord(rng));
+        else points.emplace_back(std::round(coord(rng) * 2) / 2, std::round(coord(rng) * 2) / 2);
+    }
+    std::span<const Point<double>> vertices(shape);
+    std::span<const Point<double>> query(points.data(), points.size());
+
+    Array<bool> expected;
+    expected.resize(points.size());
+    containment::polygon_contains(vertices, query, expected.data(), simd::Level::Scalar);
+    for (simd::Level level : {simd::Level::AVX2, simd::Level::AVX512}) {
+        Array<bool> actual;
+        actual.resize(points.size());
+        containment::polygon_contains(vertices, query, actual.data(), level);
+        for (size_t k = 0; k < points.size(); ++k) {
+            EXPECT_EQ(actual[k], expected[k]) << simd::level_name(level) << " " << k;
+        }
+    }
+}
+
+// ==================== ТЕСТЫ ДЛЯ СОРТИРОВКИ ФИГУР ====================
+
+namespace {
+// Порядок после std::stable_sort по ключу — эталон для поразрядной сортировки
+template<class Key>
+Array<const Figure<int>*> stable_sorted(const Array<std::shared_ptr<Figure<int>>>& figures, Key key, bool descending) {
+    Array<const Figure<int>*> result;
+    for (const auto& figure : figures) result.push_back(figure.get());
+    std::stable_sort(result.begin(), result.end(), [&](const Figure<int>* a, const Figure<int>* b) {
+        return descending ? key(*b) < key(*a) : key(*a) < key(*b);
+    });
+    return result;
+}
+
+Array<const Figure<int>*> raw_pointers(const Array<std::shared_ptr<Figure<int>>>& figures) {
+    Array<const Figure<int>*> result;
+    for (const auto& figure : figures) result.push_back(figure.get());
+    return result;
+}
+}
+
+TEST(FigureSortTest, SortByAreaIsStableAndMatchesStdStableSort) {
+    auto figures = make_scattered_figures(20000, 11);
+    auto area = [](const Figure<int>& figure) { return figure.area(); };
+    auto ascending = stable_sorted(figures, area, false);
+    auto descending = stable_sorted(figures, area, true);
+
+    auto sequential = figures;
+    sort_by_area(sequential);
+    EXPECT_TRUE(std::equal(ascending.begin(), ascending.end(), raw_pointers(sequential).begin()));
+
+    ThreadPool pool(4);
+    auto parallel = figures;
+    sort_by_area(pool, parallel, SortOrder::Descending, 1000);
+    EXPECT_TRUE(std::equal(descending.begin(), descending.end(), raw_pointers(parallel).begin()));
+    // Указатели перемещены, фигуры те же: счётчик ссылок не вырос
+    EXPECT_EQ(parallel[0].use_count(), 3);
+}
+
+TEST(FigureSortTest, SortByCenterAndCustomKeys) {
+    auto figures = make_scattered_figures(5000, 12);
+    ThreadPool pool(2);
+
+    auto by_x = figures;
+    sort_by_center_x(pool, by_x, SortOrder::Ascending, 512);
+    auto expected_x = stable_sorted(figures, [](const Figure<int>& f) { return f.center().getX(); }, false);
+    EXPECT_TRUE(std::equal(expected_x.begin(), expected_x.end(), raw_pointers(by_x).begin()));
+
+    auto by_y = figures;
+    sort_by_center_y(by_y, SortOrder::Descending);
+    auto expected_y = stable_sorted(figures, [](const Figure<int>& f) { return f.center().getY(); }, true);
+    EXPECT_TRUE(std::equal(expected_y.begin(), expected_y.end(), raw_pointers(by_y).begin()));
+
+    // Отрицательные ключи обоих видов
+    auto signed_key = [](const Figure<int>& f) { return 5000 - f.center().getX(); };
+    auto negative_area = [](const Figure<int>& f) { return -f.area(); };
+    auto by_signed = figures;
+    sort_by_key(pool, by_signed, signed_key);
+    auto expected_signed = stable_sorted(figures, signed_key, false);
+    EXPECT_TRUE(std::equal(expected_signed.begin(), expected_signed.end(), raw_pointers(by_signed).begin()));
+    auto by_negative = figures;
+    sort_by_key(by_negative, negative_area);
+    auto expected_negative = stable_sorted(figures, negative_area, false);
+    EXPECT_TRUE(std::equal(expected_negative.begin(), expected_negative.end(), raw_pointers(by_negative).begin()));
+}
+
+TEST(FigureSortTest, TopKByArea) {
+    auto figures = make_scattered_figures(10000, 13);
+    auto expected = stable_sorted(figures, [](const Figure<int>& f) { return f.area(); }, true);
+    ThreadPool pool(3);
+    for (size_t k : {size_t(0), size_t(1), size_t(10), size_t(777), size_t(10000), size_t(20000)}) {
+        auto top = top_k_by_area(pool, figures, k, 1000);
+        ASSERT_EQ(top.size(), std::min(k, figures.size()));
+        EXPECT_TRUE(std::equal(top.begin(), top.end(), expected.begin(),
+                               [](const auto& figure, const Figure<int>* raw) { return figure.get() == raw; })) << k;
+    }
+    EXPECT_EQ(top_k_by_area(figures, 5).size(), 5u);
+    EXPECT_EQ(figures.size(), 10000u);
+}
+
+TEST(FigureSortTest, NthElementByArea) {
+    auto figures = make_scattered_figures(10000, 14);
+    auto sorted = stable_sorted(figures, [](const Figure<int>& f) { return f.area(); }, false);
+    ThreadPool pool(2);
+    for (size_t n : {size_t(0), size_t(4999), size_t(9999)}) {
+        auto copy = figures;
+        nth_element_by_area(pool, copy, n, 700);
+        const double nth = copy[n]->area();
+        EXPECT_DOUBLE_EQ(nth, sorted[n]->area());
+        for (size_t i = 0; i < n; ++i) EXPECT_LE(copy[i]->area(), nth);
+        for (size_t i = n + 1; i < copy.size(); ++i) EXPECT_GE(copy[i]->area(), nth);
+    }
+    Array<std::shared_ptr<Figure<int>>> empty;
+    EXPECT_THROW(nth_element_by_area(empty, 0), std::out_of_range);
+    sort_by_area(empty);
+    EXPECT_TRUE(empty.empty());
+}
+
+// ==================== ТЕСТЫ ДЛЯ ОТЧЁТОВ ====================
+
+namespace {
+// Отчёт в том виде, в каком его печатал main.cpp через operator<<
+template<class T>
+std::string stream_report(const Array<std::shared_ptr<Figure<T>>>& figures) {
+    std::ostringstream os;
+    os << "\nFigures information:" << "\n";
+    size_t index = 0;
+    for (const auto& figure : figures) {
+        os << "Figure " << ++index << ":" << "\n";
+        os << *figure;
+        os << "Area: " << static_cast<double>(*figure) << "\n";
+        auto center = figure->center();
+        os << "Center: (" << center.getX() << ", " << center.getY() << ")" << "\n\n";
+    }
+    os << "Total area of all figures: " << total_area(figures) << "\n";
+    return os.str();
+}
+
+template<class T>
+std::string writer_report(const Array<std::shared_ptr<Figure<T>>>& figures, ReportFormat format,
+                          size_t buffer_size = ReportWriter<T>::default_buffer_size) {
+    std::ostringstream os;
+    {
+        ReportWriter<T> report(os, format, buffer_size);
+        report.begin();
+        report.write(figures);
+        report.end(total_area(figures));
+    }
+    return os.str();
+}
+}
+
+TEST(ReportWriterTest, TextMatchesStreamOutputByteForByte) {
+    auto figures = make_scattered_figures(300, 21);
+    // Площадь 40000 * 33333 помещается в int, но выводится с порядком (%g)
+    Point<int> big[] = {{-20000, 0}, {20000, 0}, {20000, 33333}, {-20000, 33333}};
+    figures.push_back(std::make_shared<Rectangle<int>>(big));
+    EXPECT_NE(stream_report(figures).find("1.33332e+09"), std::string::npos);
+    EXPECT_EQ(writer_report(figures, ReportFormat::Text), stream_report(figures));
+    // Маленький буфер: много сбросов, тот же результат
+    EXPECT_EQ(writer_report(figures, ReportFormat::Text, 1), stream_report(figures));
+
+    Array<std::shared_ptr<Figure<double>>> doubles;
+    Point<double> trap[] = {{0.1, -0.25}, {1234567.891, 0}, {3.14159265, 2.5e-7}, {-1e-12, 2.5e-7}};
+    Point<double> square[] = {{0, 0}, {1.0 / 3, 0}, {1.0 / 3, 1.0 / 3}, {0, 1.0 / 3}};
+    doubles.push_back(std::make_shared<Trapezoid<double>>(trap));
+    doubles.push_back(std::make_shared<Square<double>>(square));
+    EXPECT_EQ(writer_report(doubles, ReportFormat::Text), stream_report(doubles));
+}
+
+TEST(ReportWriterTest, CsvAndJsonLines) {
+    Array<std::shared_ptr<Figure<double>>> figures;
+    Point<double> quad[] = {{0, 0}, {0.5, 0}, {0.5, 3}, {0, 3}};
+    Point<double> trap[] = {{-1, 0}, {3, 0}, {2, 1}, {0, 1}};
+    figures.push_back(std::make_shared<Rectangle<double>>(quad));
+    figures.push_back(std::make_shared<Trapezoid<double>>(trap));
+
+    EXPECT_EQ(writer_report(figures, ReportFormat::Csv),
+              "index,kind,area,center_x,center_y,points\n"
+              "1,rectangle,1.5,0.25,1.5,0 0 0.5 0 0.5 3 0 3\n"
+              "2,trapezoid,3,1,0.5,-1 0 3 0 2 1 0 1\n");
+    EXPECT_EQ(writer_report(figures, ReportFormat::JsonLines),
+              "{\"index\":1,\"kind\":\"rectangle\",\"area\":1.5,\"center\":[0.25,1.5],"
+              "\"points\":[[0,0],[0.5,0],[0.5,3],[0,3]]}\n"
+              "{\"index\":2,\"kind\":\"trapezoid\",\"area\":3,\"center\":[1,0.5],"
+              "\"points\":[[-1,0],[3,0],[2,1],[0,1]]}\n"
+              "{\"total_area\":4.5}\n");
+
+    // Кратчайшая точная запись и null вместо NaN
+    std::ostringstream os;
+    ReportWriter<double> report(os, ReportFormat::JsonLines);
+    report.end(0.1 + 0.2);
+    report.end(std::nan(""));
+    report.flush();
+    EXPECT_EQ(os.str(), "{\"total_area\":0.30000000000000004}\n{\"total_area\":null}\n");
+}
+
+TEST(ReportWriterTest, FormatNamesAndStreamErrors) {
+    ReportFormat format = ReportFormat::Text;
+    EXPECT_TRUE(parse_report_format("csv", format));
+    EXPECT_EQ(format, ReportFormat::Csv);
+    EXPECT_TRUE(parse_report_format("jsonl", format));
+    EXPECT_EQ(format, ReportFormat::JsonLines);
+    EXPECT_FALSE(parse_report_format("xml", format));
+    EXPECT_EQ(format, ReportFormat::JsonLines);
+
+    std::ostringstream os;
+    os.setstate(std::ios::badbit);
+    ReportWriter<int> report(os);
+    report.begin();
+    EXPECT_THROW(report.flush(), std::runtime_error);
+}
+
+// ==================== ТЕСТЫ ДЛЯ CONCURRENT ARRAY ====================
+
+TEST(ConcurrentArrayTest, ParallelPushBackKeepsEveryElement) {
+    constexpr int threads = 8, per_thread = 20000;
+    auto shared = std::make_shared<int>(0);
+    ConcurrentArray<std::shared_ptr<int>> arr(16);
+    arr.push_back(shared);
+    const std::shared_ptr<int>* first = &arr[0];
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; ++t) {
+        producers.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                arr.push_back(i % 4 ? shared : std::make_shared<int>(t * per_thread + i + 1));
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+
+    // Сегменты не перемещаются
+    EXPECT_EQ(&arr[0], first);
+    ASSERT_EQ(arr.size(), size_t(threads * per_thread + 1));
+    EXPECT_EQ(shared.use_count(), 1 + 1 + threads * per_thread * 3 / 4);
+
+    Array<std::shared_ptr<int>> frozen = arr.freeze();
+    EXPECT_TRUE(arr.empty());
+    ASSERT_EQ(frozen.size(), size_t(threads * per_thread + 1));
+    EXPECT_EQ(frozen[0], shared);
+    Array<int> values;
+    for (const auto& ptr : frozen) {
+        if (ptr != shared) values.push_back(*ptr);
+    }
+    std::sort(values.begin(), values.end());
+    ASSERT_EQ(values.size(), size_t(threads * per_thread / 4));
+    for (size_t i = 1; i < values.size(); ++i) {
+        EXPECT_LT(values[i - 1], values[i]);
+    }
+    frozen.clear();
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(ConcurrentArrayTest, FreezeAdoptsFirstSegment) {
+    ConcurrentArray<int> arr(100);
+    for (int i = 0; i < 100; ++i) arr.push_back(i);
+    const int* data = &arr[0];
+    EXPECT_THROW(arr[100], std::out_of_range);
+
+    Array<int> frozen = arr.freeze();
+    EXPECT_EQ(frozen.data(), data);
+    EXPECT_EQ(frozen.size(), 100);
+    EXPECT_EQ(frozen.capacity(), 128);
+    EXPECT_EQ(frozen[99], 99);
+    EXPECT_EQ(arr.size(), 0);
+
+    // Повторное заполнение после freeze, несколько сегментов
+    for (int i = 0; i < 1000; ++i) arr.emplace_back(i);
+    frozen = arr.freeze();
+    ASSERT_EQ(frozen.size(), 1000);
+    EXPECT_EQ(frozen[500], 500);
+}
+
+TEST(ConcurrentArrayTest, FreezeMovesNonRelocatableElements) {
+    ConcurrentArray<std::string> arr(2);
+    for (int i = 0; i < 10; ++i) arr.emplace_back(size_t(20), char('a' + i));
+    Array<std::string> frozen = arr.freeze();
+    ASSERT_EQ(frozen.size(), 10);
+    EXPECT_EQ(frozen[0], std::string(20, 'a'));
+    EXPECT_EQ(frozen[9], std::string(20, 'j'));
+    EXPECT_TRUE(arr.freeze().empty());
+}
+
+// ==================== ТЕСТЫ ДЛЯ КОНВЕЙЕРА ====================
+
+TEST(SpscRingTest, DeliversInOrderAcrossThreads) {
+    SpscRing<int> ring(3);
+    constexpr int count = 100000;
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i) {
+            ASSERT_TRUE(ring.push(i));
+        }
+        ring.close();
+    });
+    int expected = 0, value = -1;
+    while (ring.pop(value)) {
+        ASSERT_EQ(value, expected++);
+    }
+    producer.join();
+    EXPECT_EQ(expected, count);
+    QueueStats stats = ring.stats();
+    EXPECT_EQ(stats.capacity, 3);
+    EXPECT_EQ(stats.pushes, size_t(count));
+    EXPECT_LE(stats.max_occupancy, 3);
+    EXPECT_GE(stats.average_occupancy, 1.0);
+}
+
+TEST(SpscRingTest, CloseDrainsAndRejects) {
+    SpscRing<std::string> ring(2);
+    EXPECT_TRUE(ring.push("a"));
+    EXPECT_TRUE(ring.push("b"));
+    ring.close();
+    EXPECT_FALSE(ring.push("c"));
+    std::string value;
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, "a");
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, "b");
+    EXPECT_FALSE(ring.pop(value));
+}
+
+TEST(PipelineTest, MatchesBatchLoadWithSmallChunks) {
+    std::string text;
+    for (int i = 0; i < 3000; ++i) {
+        const std::string s = std::to_string(i % 17 + 1);
+        if (i % 500 == 7) text += "bogus 1 2\n";
+        if (i % 700 == 3) text += "square" + std::string(300, ' ') + "0 0 1 0 1 1 0 1\n";
+        text += (i % 2 ? "rectangle 0 0 " : "square 0 0 ") + s + " 0 " + s + " " + s + " 0 " + s + "\n";
+    }
+    text += "trapezoid 0 0 4 0 3 2 1 2";  // без перевода строки в конце
+
+    LoadResult<int> loaded = parse_figures<int>(text);
+    std::ostringstream expected;
+    {
+        ReportWriter<int> report(expected, ReportFormat::Csv);
+        report.write(loaded.figures);
+    }
+
+    std::istringstream in(text);
+    std::ostringstream actual;
+    Array<LoadError> errors;
+    PipelineStats stats;
+    {
+        ReportWriter<int> report(actual, ReportFormat::Csv);
+        PipelineOptions options;
+        options.chunk_size = 64;
+        options.queue_capacity = 2;
+        stats = run_figure_pipeline<int>(in, report, [&](const LoadError& error) { errors.push_back(error); }, options);
+    }
+
+    EXPECT_EQ(actual.str(), expected.str());
+    EXPECT_EQ(stats.figures, loaded.figures.size());
+    EXPECT_DOUBLE_EQ(stats.total_area, total_area(loaded.figures));
+    ASSERT_EQ(errors.size(), loaded.errors.size());
+    for (size_t i = 0; i < errors.size(); ++i) {
+        EXPECT_EQ(errors[i].line, loaded.errors[i].line);
+        EXPECT_EQ(errors[i].message, loaded.errors[i].message);
+    }
+    EXPECT_EQ(stats.stages[0].units, text.size());
+    EXPECT_GT(stats.stages[0].batches, 100);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(stats.queues[i].pushes, stats.stages[i].batches);
+        EXPECT_LE(stats.queues[i].max_occupancy, 2);
+    }
+}
+
+TEST(PipelineTest, WriterFailureStopsAllStages) {
+    std::string text;
+    for (int i = 0; i < 20000; ++i) text += "square 0 0 2 0 2 2 0 2\n";
+    std::istringstream in(text);
+    std::ostringstream out;
+    out.setstate(std::ios::badbit);
+    ReportWriter<int> report(out, ReportFormat::Text, 64);
+    PipelineOptions options;
+    options.chunk_size = 256;
+    options.queue_capacity = 1;
+    EXPECT_THROW(run_figure_pipeline<int>(in, report, [](const LoadError&) {}, options), std::runtime_error);
+}
+
+// ==================== ТЕСТЫ ДЛЯ СВОДНЫХ ВЕЛИЧИН КОЛЛЕКЦИИ ====================
+
+std::shared_ptr<Figure<int>> make_square_at(int x, int y, int side) {
+    Point<int> points[] = {{x, y}, {x + side, y}, {x + side, y + side}, {x, y + side}};
+    return std::make_shared<Square<int>>(points);
+}
+
+TEST(FigureCollectionTest, TracksAggregatesThroughInsertAndErase) {
+    FigureCollection<int> collection;
+    EXPECT_EQ(collection.total_area(), 0.0);
+    EXPECT_EQ(collection.centroid().getX(), 0.0);
+
+    collection.push_back(make_square_at(0, 0, 2));
+    collection.push_back(make_square_at(10, -4, 4));
+    Point<int> trap[] = {{-6, 0}, {0, 0}, {-2, 3}, {-4, 3}};
+    collection.push_back(std::make_shared<Trapezoid<int>>(trap));
+    EXPECT_THROW(collection.push_back(nullptr), std::invalid_argument);
+
+    EXPECT_DOUBLE_EQ(collection.total_area(), 4 + 16 + 12);
+    EXPECT_EQ(collection.count(FigureKind::Square), 2);
+    EXPECT_EQ(collection.count(FigureKind::Trapezoid), 1);
+    EXPECT_DOUBLE_EQ(collection.area(FigureKind::Square), 20);
+    EXPECT_DOUBLE_EQ(collection.area(FigureKind::Rectangle), 0);
+    BoundingBox<int> box = collection.bounding_box();
+    EXPECT_EQ(box.min.getX(), -6);
+    EXPECT_EQ(box.min.getY(), -4);
+    EXPECT_EQ(box.max.getX(), 14);
+    EXPECT_EQ(box.max.getY(), 3);
+
+    // Удаление фигур на краях габарита сужает его без полного обхода
+    collection.erase(1);
+    box = collection.bounding_box();
+    EXPECT_EQ(box.max.getX(), 2);
+    EXPECT_EQ(box.min.getY(), 0);
+    collection.erase_unordered(1);
+    ASSERT_EQ(collection.size(), 1);
+    EXPECT_DOUBLE_EQ(collection.total_area(), 4);
+    EXPECT_DOUBLE_EQ(collection.centroid().getX(), 1);
+    EXPECT_EQ(collection.bounding_box().min.getX(), 0);
+    EXPECT_THROW(collection.erase(1), std::out_of_range);
+
+    collection.modify(0, [](Figure<int>& figure) { figure.add_point(Point<int>(1, 5)); });
+    EXPECT_EQ(collection.bounding_box().max.getY(), 5);
+    EXPECT_DOUBLE_EQ(collection.total_area(), collection[0]->area());
+
+    // Исключение после изменения фигуры не оставляет устаревший вклад
+    EXPECT_THROW(collection.modify(0, [](Figure<int>& figure) {
+        figure.add_point(Point<int>(-3, 7));
+        throw std::runtime_error("modify failed");
+    }), std::runtime_error);
+    EXPECT_EQ(collection.bounding_box().min.getX(), -3);
+    EXPECT_EQ(collection.bounding_box().max.getY(), 7);
+    EXPECT_DOUBLE_EQ(collection.total_area(), collection[0]->area());
+
+    collection.erase(0);
+    EXPECT_TRUE(collection.empty());
+    EXPECT_EQ(collection.count(FigureKind::Square), 0);
+    EXPECT_EQ(collection.bounding_box().max.getX(), 0);
+}
+
+TEST(FigureCollectionTest, CompensatedSumsDoNotDrift) {
+    auto square = [](double x, double y, double side) {
+        Point<double> points[] = {{x, y}, {x + side, y}, {x + side, y + side}, {x, y + side}};
+        return std::make_shared<Square<double>>(points);
+    };
+    FigureCollection<double> collection;
+    // Площадь 1e16: в обычной сумме единицы к ней уже не прибавляются
+    collection.push_back(square(0, 0, 1e8));
+    for (int i = 0; i < 1000; ++i) {
+        collection.push_back(square(i, i, 1));
+    }
+    collection.erase(0);
+    EXPECT_EQ(collection.total_area(), 1000.0);
+    EXPECT_EQ(collection.area(FigureKind::Square), 1000.0);
+
+    // Длинная серия добавлений и удалений площадей разного порядка
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> side(0.001, 1e6);
+    for (int i = 0; i < 20000; ++i) {
+        collection.push_back(square(0, 0, side(rng)));
+        collection.erase_unordered(static_cast<size_t>(rng()) % collection.size());
+    }
+    double exact = 0;
+    for (const auto& figure : collection.figures()) exact += figure->area();
+    EXPECT_NEAR(collection.total_area(), exact, exact * 1e-15);
+}
+
+TEST(FigureCollectionTest, InfiniteAreaLeavesWithItsFigure) {
+    auto square = [](double x, double y, double side) {
+        Point<double> points[] = {{x, y}, {x + side, y}, {x + side, y + side}, {x, y + side}};
+        return std::make_shared<Square<double>>(points);
+    };
+    FigureCollection<double> collection;
+    collection.push_back(square(0, 0, 2));
+    collection.push_back(square(1e200, 1e200, 1e200));
+    collection.push_back(square(5, 5, 3));
+    EXPECT_TRUE(std::isinf(collection.total_area()));
+    EXPECT_TRUE(std::isinf(collection.area(FigureKind::Square)));
+
+    collection.erase(1);
+    EXPECT_EQ(collection.total_area(), 4.0 + 9.0);
+    EXPECT_EQ(collection.area(FigureKind::Square), 4.0 + 9.0);
+    EXPECT_EQ(collection.centroid().getX(), (1.0 + 6.5) / 2);
+    EXPECT_EQ(collection.bounding_box().max.getX(), 8.0);
+
+    // То же через erase_unordered и update
+    collection.push_back(square(1e200, 1e200, 1e200));
+    collection.erase_unordered(2);
+    EXPECT_EQ(collection.total_area(), 4.0 + 9.0);
+    collection.push_back(square(1e200, 1e200, 1e200));
+    collection.modify(2, [](Figure<double>& figure) { figure.transform(AffineTransform::scaling(1e-200)); });
+    EXPECT_NEAR(collection.total_area(), 4.0 + 9.0 + 1.0, 1e-9);
+}
+
+TEST(FigureCollectionTest, NaNCoordinatesStayOutOfBoundingBox) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Point<double> good[] = {{0, 0}, {2, 0}, {2, 2}, {0, 2}};
+    Point<double> bad[] = {{nan, 1}, {3, 1}, {3, nan}, {1, 3}};
+    FigureCollection<double> collection;
+    collection.push_back(std::make_shared<Square<double>>(good));
+    for (int i = 0; i < 3; ++i) {
+        collection.push_back(std::make_shared<Rectangle<double>>(bad));
+    }
+    EXPECT_EQ(collection.bounding_box().max.getX(), 2.0);
+    EXPECT_EQ(collection.bounding_box().max.getY(), 2.0);
+
+    collection.erase(2);
+    collection.erase_unordered(1);
+    collection.erase(1);
+    ASSERT_EQ(collection.size(), 1);
+    EXPECT_EQ(collection.total_area(), 4.0);
+    EXPECT_EQ(collection.bounding_box().min.getX(), 0.0);
+    EXPECT_EQ(collection.bounding_box().max.getY(), 2.0);
+}
+
+// ==================== ТЕСТЫ ДЛЯ МНОГОУГОЛЬНИКОВ И ВЫПУКЛОЙ ОБОЛОЧКИ ====================
+
+TEST(PolygonGeometryTest, AreaCentroidAndPerimeter) {
+    // Г-образная фигура: прямоугольники 4x1 и 1x2
+    std::vector<Point<int>> shape = {{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 3}, {0, 3}};
+    PolygonFigure<int> polygon{std::span<const Point<int>>(shape)};
+    EXPECT_DOUBLE_EQ(polygon.area(), 6.0);
+    EXPECT_DOUBLE_EQ(polygon.perimeter(), 14.0);
+    EXPECT_DOUBLE_EQ(polygon.centroid().getX(), 1.5);
+    EXPECT_DOUBLE_EQ(polygon.centroid().getY(), 1.0);
+
+    // Обход по часовой стрелке и сдвиг от начала координат
+    std::vector<Point<double>> shifted;
+    for (auto it = shape.rbegin(); it != shape.rend(); ++it) {
+        shifted.emplace_back(it->getX() + 1e6, it->getY() - 1e6);
+    }
+    PolygonFigure<double> far{std::span<const Point<double>>(shifted)};
+    EXPECT_DOUBLE_EQ(far.area(), 6.0);
+    EXPECT_DOUBLE_EQ(far.centroid().getX(), 1e6 + 1.5);
+    EXPECT_DOUBLE_EQ(far.centroid().getY(), -1e6 + 1.0);
+
+    // Нулевая площадь: центр масс — среднее вершин
+    Point<int> segment[] = {{0, 0}, {2, 2}, {4, 4}};
+    PolygonFigure<int> degenerate{std::span<const Point<int>>(segment)};
+    EXPECT_EQ(degenerate.area(), 0.0);
+    EXPECT_DOUBLE_EQ(degenerate.centroid().getX(), 2.0);
+    EXPECT_DOUBLE_EQ(degenerate.perimeter(), 2 * std::sqrt(32.0));
+}
+
+TEST(PolygonGeometryTest, CenterWithNegativeCoordinates) {
+    Point<int> shape[] = {{-2, -4}, {-8, -4}, {-10, -9}, {-5, -13}, {-1, -9}};
+    PolygonFigure<int> polygon{std::span<const Point<int>>(shape)};
+    // Суммы -26 и -39 делятся на 5 с округлением вниз
+    EXPECT_EQ(polygon.center().getX(), -6);
+    EXPECT_EQ(polygon.center().getY(), -8);
+
+    FixedPolygon<int, 5> fixed({shape[0], shape[1], shape[2], shape[3], shape[4]});
+    EXPECT_EQ(make_figure(fixed)->center().getX(), fixed.center().getX());
+
+    Array<std::shared_ptr<Figure<int>>> figures;
+    figures.push_back(std::make_shared<PolygonFigure<int>>(std::span<const Point<int>>(shape)));
+    const FigureStore<int> store = FigureStore<int>::from_figures(figures);
+    EXPECT_EQ(store.center(0).getX(), -6);
+    EXPECT_EQ(store.center(0).getY(), -8);
+
+    FigureCollection<int> collection(figures);
+    EXPECT_DOUBLE_EQ(collection.centroid().getX(), -6);
+
+    PolygonFigure<int> empty{std::span<const Point<int>>()};
+    EXPECT_EQ(empty.center().getX(), 0);
+    EXPECT_EQ(empty.area(), 0.0);
+}
+
+TEST(ConvexHullTest, SmallAndDegenerateInputs) {
+    EXPECT_TRUE(convex_hull(std::span<const Point<int>>()).empty());
+
+    Point<int> same[] = {{3, 3}, {3, 3}, {3, 3}};
+    EXPECT_EQ(convex_hull(std::span<const Point<int>>(same)).size(), 1);
+
+    // Точки на одной прямой: остаются концы отрезка
+    Point<int> line[] = {{2, 2}, {0, 0}, {1, 1}, {3, 3}};
+    auto segment = convex_hull(std::span<const Point<int>>(line));
+    ASSERT_EQ(segment.size(), 2);
+    EXPECT_EQ(segment[0].getX(), 0);
+    EXPECT_EQ(segment[1].getX(), 3);
+
+    // Решётка с повторами: только углы, против часовой стрелки от (0, 0)
+    std::vector<Point<int>> grid;
+    for (int x = 0; x < 10; ++x) {
+        for (int y = 0; y < 10; ++y) {
+            grid.emplace_back(x, y);
+            grid.emplace_back(x, y);
+        }
+    }
+    auto hull = convex_hull(std::span<const Point<int>>(grid));
+    ASSERT_EQ(hull.size(), 4);
+    const int expected[][2] = {{0, 0}, {9, 0}, {9, 9}, {0, 9}};
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(hull[i].getX(), expected[i][0]);
+        EXPECT_EQ(hull[i].getY(), expected[i][1]);
+    }
+}
+
+TEST(ConvexHullTest, ParallelMatchesSequential) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> coord(-100000, 100000);
+    std::vector<Point<int>> points;
+    for (int i = 0; i < 200000; ++i) {
+        const int x = coord(rng), y = coord(rng);
+        // Точки внутри круга: вершин у оболочки много
+        if (static_cast<long long>(x) * x + static_cast<long long>(y) * y <= 10000000000LL) points.emplace_back(x, y);
+    }
+    const std::span<const Point<int>> input(points);
+    const auto sequential = convex_hull(input);
+    ThreadPool pool(4);
+    const auto parallel = convex_hull(pool, input, 1000);
+    ASSERT_EQ(parallel.size(), sequential.size());
+    for (size_t i = 0; i < sequential.size(); ++i) {
+        EXPECT_EQ(parallel[i].getX(), sequential[i].getX());
+        EXPECT_EQ(parallel[i].getY(), sequential[i].getY());
+    }
+
+    // Оболочка выпукла и содержит все точки
+    const size_t n = sequential.size();
+    ASSERT_GT(n, 20);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_GT(hull_detail::cross(sequential[i], sequential[(i + 1) % n], sequential[(i + 2) % n]), 0);
+    }
+    PolygonFigure<int> hull{std::span<const Point<int>>(sequential.data(), n)};
+    Array<bool> inside = hull.contains(input);
+    EXPECT_TRUE(std::all_of(inside.begin(), inside.end(), [](bool value) { return value; }));
+}
+
+// ==================== ТЕСТЫ ДЛЯ АФФИННЫХ ПРЕОБРАЗОВАНИЙ ====================
+
+TEST(AffineTransformTest, FactoriesCompositionAndRounding) {
+    // Сначала масштаб, затем сдвиг
+    const AffineTransform m = AffineTransform::translation(1, 2) * AffineTransform::scaling(3, 4);
+    const Point<double> p = m.apply(Point<double>(1, 1));
+    EXPECT_DOUBLE_EQ(p.getX(), 4);
+    EXPECT_DOUBLE_EQ(p.getY(), 6);
+    EXPECT_DOUBLE_EQ(m.determinant(), 12);
+    EXPECT_TRUE(m.preserves_axes());
+    EXPECT_TRUE(m.has_integer_coefficients());
+
+    const AffineTransform turn = AffineTransform::rotation(std::acos(-1.0) / 2, Point<double>(1, 1));
+    const Point<double> q = turn.apply(Point<double>(2, 1));
+    EXPECT_NEAR(q.getX(), 1, 1e-12);
+    EXPECT_NEAR(q.getY(), 2, 1e-12);
+    EXPECT_NEAR(turn.determinant(), 1, 1e-12);
+    EXPECT_FALSE(turn.preserves_axes());
+
+    // Целые координаты округляются к ближайшему, половины — вверх
+    const Point<int> r = AffineTransform::scaling(0.5).apply(Point<int>(3, -3));
+    EXPECT_EQ(r.getX(), 2);
+    EXPECT_EQ(r.getY(), -1);
+}
+
+TEST(AffineTransformTest, KernelsMatchScalarOnEveryLevel) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> coord(-1e4, 1e4);
+    const AffineTransform m = AffineTransform::rotation(0.3) * AffineTransform::scaling(1.7, -0.6)
+                            * AffineTransform::translation(12.5, -3.25);
+    // Число точек не кратно блоку и ширине регистра
+    Array<Point<double>> doubles;
+    Array<Point<int>> ints;
+    for (int i = 0; i < 1000; ++i) {
+        doubles.push_back(Point<double>(coord(rng), coord(rng)));
+        ints.push_back(Point<int>(static_cast<int>(coord(rng)), static_cast<int>(coord(rng))));
+    }
+    for (simd::Level level : {simd::Level::Scalar, simd::Level::SSE2, simd::Level::AVX2, simd::Level::AVX512}) {
+        Array<Point<double>> d = doubles;
+        Array<Point<int>> n = ints;
+        affine::transform_points(m, d.data(), d.size(), level);
+        affine::transform_points(m, n.data(), n.size(), level);
+        Array<int> xs, ys;
+        for (const Point<int>& point : ints) {
+            xs.push_back(point.getX());
+            ys.push_back(point.getY());
+        }
+        affine::transform_columns(m, xs.data(), ys.data(), xs.size(), level);
+        for (size_t i = 0; i < doubles.size(); ++i) {
+            const Point<double> expected = m.apply(doubles[i]);
+            EXPECT_EQ(std::memcmp(&d[i], &expected, sizeof(expected)), 0) << simd::level_name(level) << " " << i;
+            const Point<int> rounded = m.apply(ints[i]);
+            EXPECT_EQ(n[i].getX(), rounded.getX());
+            EXPECT_EQ(n[i].getY(), rounded.getY());
+            EXPECT_EQ(xs[i], rounded.getX());
+            EXPECT_EQ(ys[i], rounded.getY());
+        }
+    }
+}
+
+TEST(AffineTransformTest, FigureCachesStayConsistent) {
+    Point<double> shape[] = {{0, 0}, {6, 0}, {4, 3}, {1, 3}, {-1, 2}};
+    PolygonFigure<double> polygon{std::span<const Point<double>>(shape)};
+    const PolygonFigure<double> copy(polygon);
+    (void)polygon.area();
+    (void)polygon.center();
+    (void)polygon.bounding_box();
+    const auto version = polygon.version();
+
+    const AffineTransform m = AffineTransform::rotation(0.4) * AffineTransform::scaling(2, 3);
+    polygon.transform(m);
+    EXPECT_GT(polygon.version(), version);
+    // Копия разделяла буфер вершин и не изменилась
+    EXPECT_EQ(copy.get_point(1).getX(), 6);
+
+    Array<Point<double>> moved;
+    for (const Point<double>& point : shape) moved.push_back(m.apply(point));
+    const PolygonFigure<double> fresh{std::span<const Point<double>>(moved.data(), moved.size())};
+    EXPECT_NEAR(polygon.area(), fresh.area(), 1e-9);
+    EXPECT_NEAR(polygon.center().getX(), fresh.center().getX(), 1e-12);
+    EXPECT_NEAR(polygon.center().getY(), fresh.center().getY(), 1e-12);
+    EXPECT_EQ(polygon.bounding_box().min.getX(), fresh.bounding_box().min.getX());
+    EXPECT_EQ(polygon.bounding_box().max.getY(), fresh.bounding_box().max.getY());
+
+    // Целые координаты: целый масштаб переносит площадь, отражение меняет
+    // стороны габарита местами, дробный масштаб сбрасывает площадь
+    Point<int> trap[] = {{0, 0}, {7, 0}, {5, 3}, {1, 3}};
+    for (const AffineTransform& t : {AffineTransform::scaling(-2, 3), AffineTransform::scaling(1.5)}) {
+        Trapezoid<int> figure{std::span<const Point<int>>(trap)};
+        (void)figure.area();
+        (void)figure.center();
+        (void)figure.bounding_box();
+        figure.transform(t);
+        Point<int> expected[4];
+        for (size_t i = 0; i < 4; ++i) expected[i] = t.apply(trap[i]);
+        const Trapezoid<int> reference{std::span<const Point<int>>(expected)};
+        EXPECT_EQ(figure.area(), reference.area());
+        EXPECT_EQ(figure.center().getX(), reference.center().getX());
+        EXPECT_EQ(figure.center().getY(), reference.center().getY());
+        EXPECT_EQ(figure.bounding_box().min.getX(), reference.bounding_box().min.getX());
+        EXPECT_EQ(figure.bounding_box().max.getX(), reference.bounding_box().max.getX());
+        EXPECT_EQ(figure.bounding_box().max.getY(), reference.bounding_box().max.getY());
+    }
+
+    // Квадрат и прямоугольник считают площадь по сторонам вдоль осей:
+    // площадь из кэша должна совпадать с пересчётом при любом преобразовании
+    const AffineTransform quarter_turn{0, -1, 0, 1, 0, 0};
+    const AffineTransform transforms[] = {AffineTransform::rotation(0.5), quarter_turn,
+                                          AffineTransform::scaling(2, 3), AffineTransform::scaling(-2, 2),
+                                          AffineTransform::translation(5, -1)};
+    auto check = [&](auto make) {
+        for (const AffineTransform& t : transforms) {
+            auto warm = make();
+            auto cold = make();
+            (void)warm.area();
+            warm.transform(t);
+            cold.transform(t);
+            EXPECT_DOUBLE_EQ(warm.area(), cold.area());
+        }
+    };
+    Point<double> square_d[] = {{0, 0}, {2, 0}, {2, 2}, {0, 2}};
+    Point<int> square_i[] = {{0, 0}, {2, 0}, {2, 2}, {0, 2}};
+    Point<double> rect_d[] = {{0, 0}, {4, 0}, {4, 1}, {0, 1}};
+    Point<int> rect_i[] = {{0, 0}, {4, 0}, {4, 1}, {0, 1}};
+    check([&] { return Square<double>{std::span<const Point<double>>(square_d)}; });
+    check([&] { return Square<int>{std::span<const Point<int>>(square_i)}; });
+    check([&] { return Rectangle<double>{std::span<const Point<double>>(rect_d)}; });
+    check([&] { return Rectangle<int>{std::span<const Point<int>>(rect_i)}; });
+
+    // Равномерный масштаб и сдвиг сохраняют кэш площади квадрата
+    Square<double> square{std::span<const Point<double>>(square_d)};
+    (void)square.area();
+    square.transform(AffineTransform::translation(1, 1) * AffineTransform::scaling(-3));
+    EXPECT_DOUBLE_EQ(square.area(), 36);
+
+    // Переполненная площадь не остаётся в кэше после обратного масштаба
+    Rectangle<double> huge{std::span<const Point<double>>(rect_d)};
+    huge.transform(AffineTransform::scaling(1e200));
+    EXPECT_FALSE(std::isfinite(huge.area()));
+    huge.transform(AffineTransform::scaling(1e-200));
+    EXPECT_NEAR(huge.area(), 4.0, 1e-9);
+}
+
+TEST(AffineTransformTest, BatchTransformsOverCollections) {
+    auto make = [] {
+        Array<std::shared_ptr<Figure<double>>> figures;
+        for (int i = 0; i < 300; ++i) {
+            const double s = i % 7 + 1;
+            Point<double> quad[] = {{0.5 * i, 0}, {0.5 * i + s, 0}, {0.5 * i + s, 2 * s}, {0.5 * i, 2 * s}};
+            figures.push_back(make_figure<double>(i % 2 ? FigureKind::Rectangle : FigureKind::Trapezoid, quad));
+        }
+        return figures;
+    };
+    const AffineTransform m = AffineTransform::translation(-4, 9) * AffineTransform::scaling(2.5, 0.5);
+
+    auto sequential = make();
+    auto parallel = make();
+    FigureStore<double> store = FigureStore<double>::from_figures(sequential);
+    FigureCollection<double> collection(make());
+    const double area_before = collection.total_area();
+
+    transform_figures(sequential, m);
+    ThreadPool pool(3);
+    transform_figures(pool, parallel, m, 16);
+    store.transform(m);
+    collection.transform(m);
+
+    for (size_t i = 0; i < sequential.size(); ++i) {
+        for (size_t v = 0; v < 4; ++v) {
+            EXPECT_EQ(parallel[i]->get_point(v).getX(), sequential[i]->get_point(v).getX());
+            EXPECT_EQ(collection[i]->get_point(v).getY(), sequential[i]->get_point(v).getY());
+        }
+        EXPECT_DOUBLE_EQ(store.area(i), sequential[i]->area());
+    }
+    EXPECT_NEAR(collection.total_area(), area_before * 1.25, 1e-9);
+    EXPECT_DOUBLE_EQ(collection.bounding_box().min.getX(), -4);
+}
+
 // ==================== ИНТЕГРАЦИОННЫЕ ТЕСТЫ ====================
 
 TEST(IntegrationTest, CompleteWorkflow) {